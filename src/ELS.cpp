@@ -6,6 +6,22 @@
 #include <string>
 #include <unordered_set>
 #include <unordered_map>
+#include <cstdint>
+#include <queue>
+#include <numeric>
+#include <sstream>
+#include <cstring>
+#include <climits>
+#include <cerrno>
+#include <list>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <chrono>
+#include "progress_monitor.h"
+#include "bigmem.h"
+#include "csr_builder.h"
 
 using namespace std;
 
@@ -20,8 +36,59 @@ vector<int> largest_clique;
 // Store mapping from internal indices to original node IDs
 vector<int> index_to_node;
 
-// Function to compute degeneracy ordering
-vector<int> degeneracyOrdering(const Graph& graph) {
+// Number of maximal cliques of each size
+vector<long long> clique_size_count;
+
+// Load banners go here; --serve moves them to stderr so that stdout only
+// carries answers
+ostream* status_out = &cout;
+
+// --cliques: every reported maximal clique is written here, one per line
+ostream* clique_out = nullptr;
+
+// Counters read by the progress monitor thread
+ProgressCounters progress;
+
+// Publish the number and total size of the root subproblems about to run
+void beginRoots(long long roots, long long work) {
+    progress.roots_total.fetch_add(roots, memory_order_relaxed);
+    progress.work_total.fetch_add(work, memory_order_relaxed);
+}
+
+// Mark a root subproblem of the given size as finished
+void finishRoot(long long work) {
+    progress.roots_done.fetch_add(1, memory_order_relaxed);
+    progress.work_done.fetch_add(work, memory_order_relaxed);
+}
+
+// Summed size 1 + |P| of all root subproblems: every edge has exactly one
+// endpoint later in the ordering
+long long rootWork(const Graph& graph) {
+    long long work = 0;
+    for (const auto& adj : graph) work += adj.size();
+    return graph.size() + work / 2;
+}
+
+// Orders cliques so that the smallest one sits on top of the heap
+struct LargerClique {
+    bool operator()(const vector<int>& a, const vector<int>& b) const {
+        return a.size() > b.size();
+    }
+};
+
+// Top-k mode: keep only the top_k largest maximal cliques (0 = report all)
+int top_k = 0;
+priority_queue<vector<int>, vector<vector<int>>, LargerClique> top_cliques;
+
+// Size a clique must exceed to enter the top-k heap
+size_t topKBound() {
+    if (top_k == 0 || (int)top_cliques.size() < top_k) return 0;
+    return top_cliques.top().size();
+}
+
+// Function to compute degeneracy ordering; optionally also the core number
+// of every vertex
+vector<int> degeneracyOrdering(const Graph& graph, vector<int>* core = nullptr) {
     int n = graph.size();
     vector<int> ordering;
     ordering.reserve(n);
@@ -30,6 +97,8 @@ vector<int> degeneracyOrdering(const Graph& graph) {
     vector<set<int>> verticesByDegree(n);
     vector<int> degree(n, 0);
     vector<bool> used(n, false);
+    if (core) core->assign(n, 0);
+    int current_core = 0;
     
     // Initialize degrees and verticesByDegree
     for (int i = 0; i < n; i++) {
@@ -48,6 +117,8 @@ vector<int> degeneracyOrdering(const Graph& graph) {
         verticesByDegree[d].erase(verticesByDegree[d].begin());
         used[v] = true;
         ordering.push_back(v);
+        current_core = max(current_core, d);
+        if (core) (*core)[v] = current_core;
         
         // Update degrees of neighbors
         for (int u : graph[v]) {
@@ -62,41 +133,234 @@ vector<int> degeneracyOrdering(const Graph& graph) {
     return ordering;
 }
 
+// Function to check if a vertex is a neighbor efficiently
+bool isNeighbor(const vector<int>& neighbors, int vertex) {
+    // Binary search since we keep adjacency lists sorted
+    return binary_search(neighbors.begin(), neighbors.end(), vertex);
+}
+
+// Result of the pre-reduction stage: the kernel handed to the enumerators plus
+// everything needed to map its cliques back to the input graph
+struct Reduction {
+    Graph kernel;                       // Reduced graph with compact indices
+    vector<int> kernel_to_index;        // Kernel index -> graph index
+    vector<vector<int>> twins;          // Graph index -> twins collapsed into it
+    vector<vector<int>> peeled_cliques; // Maximal cliques emitted while peeling
+    set<vector<int>> suppressed;        // Cliques that stop being maximal once peeled vertices return
+    int twins_collapsed = 0;
+    int vertices_peeled = 0;
+};
+
+// When set, maximal cliques are collected here instead of counted
+vector<vector<int>>* clique_sink = nullptr;
+
+// Reduction whose kernel is currently being enumerated (nullptr if none)
+const Reduction* active_reduction = nullptr;
+
+// Local subgraph index -> graph index while a local subproblem is enumerated
+const vector<int>* local_to_global = nullptr;
+
+// Count a maximal clique given in graph indices
+void recordClique(const vector<int>& R);
+
+// Hash of the closed neighborhood N[v], independent of element order
+static uint64_t closedNeighborhoodHash(const Graph& graph, int v) {
+    auto mix = [](uint64_t x) {
+        x += 0x9e3779b97f4a7c15ULL;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    };
+    uint64_t h = mix(v);
+    for (int u : graph[v]) h += mix(u);
+    return h;
+}
+
+// True if u and v have identical closed neighborhoods
+static bool areTwins(const Graph& graph, int u, int v) {
+    if (graph[u].size() != graph[v].size()) return false;
+    if (!binary_search(graph[u].begin(), graph[u].end(), v)) return false;
+    vector<int> nu = graph[u], nv = graph[v];
+    nu.insert(lower_bound(nu.begin(), nu.end(), u), u);
+    nv.insert(lower_bound(nv.begin(), nv.end(), v), v);
+    return nu == nv;
+}
+
+// Record a clique found while peeling; it is filtered against the suppressed
+// set when reported, like kernel cliques
+static void emitPeeledClique(Reduction& red, vector<int> C) {
+    sort(C.begin(), C.end());
+    red.peeled_cliques.push_back(C);
+}
+
+// Pre-reduction stage.
+// 1. Vertices with identical closed neighborhoods always appear in the same
+//    maximal cliques, so each class is collapsed into one representative.
+// 2. Vertices of degree <= 2 are peeled repeatedly; the maximal cliques through
+//    them are read off their (at most two) neighbors directly. When v is peeled,
+//    the maximal cliques M of N(v) become non-maximal in the input graph and
+//    are remembered so they can be dropped if the kernel reports them later.
+// The kernel feeds the ELS drivers only; tomita enumerates its full input.
+void reduceGraph(const Graph& graph, Reduction& red) {
+    int n = graph.size();
+    vector<bool> alive(n, true);
+    red.twins.assign(n, {});
+
+    // Collapse twins
+    unordered_map<uint64_t, vector<int>> buckets;
+    for (int v = 0; v < n; v++) {
+        if (!graph[v].empty()) buckets[closedNeighborhoodHash(graph, v)].push_back(v);
+    }
+    for (auto& [h, group] : buckets) {
+        for (size_t i = 0; i < group.size(); i++) {
+            int rep = group[i];
+            if (!alive[rep]) continue;
+            for (size_t j = i + 1; j < group.size(); j++) {
+                int v = group[j];
+                if (alive[v] && areTwins(graph, rep, v)) {
+                    alive[v] = false;
+                    red.twins[rep].push_back(v);
+                    red.twins_collapsed++;
+                }
+            }
+        }
+    }
+
+    // Peel low-degree vertices
+    vector<int> degree(n, 0);
+    vector<int> queue;
+    for (int v = 0; v < n; v++) {
+        if (!alive[v]) continue;
+        for (int u : graph[v]) {
+            if (alive[u]) degree[v]++;
+        }
+        if (degree[v] <= 2) queue.push_back(v);
+    }
+    while (!queue.empty()) {
+        int v = queue.back();
+        queue.pop_back();
+        if (!alive[v] || degree[v] > 2) continue;
+
+        vector<int> nb;
+        for (int u : graph[v]) {
+            if (alive[u]) nb.push_back(u);
+        }
+
+        vector<vector<int>> M;
+        if (nb.empty()) {
+            emitPeeledClique(red, {v});
+        } else if (nb.size() == 1 || isNeighbor(graph[nb[0]], nb[1])) {
+            vector<int> C = nb;
+            C.push_back(v);
+            emitPeeledClique(red, C);
+            M.push_back(nb);
+        } else {
+            emitPeeledClique(red, {v, nb[0]});
+            emitPeeledClique(red, {v, nb[1]});
+            M.push_back({nb[0]});
+            M.push_back({nb[1]});
+        }
+        for (auto& m : M) {
+            sort(m.begin(), m.end());
+            red.suppressed.insert(m);
+        }
+
+        alive[v] = false;
+        red.vertices_peeled++;
+        for (int u : nb) {
+            if (--degree[u] <= 2) queue.push_back(u);
+        }
+    }
+
+    // Build the kernel over the surviving vertices
+    vector<int> index_to_kernel(n, -1);
+    for (int v = 0; v < n; v++) {
+        if (alive[v]) {
+            index_to_kernel[v] = red.kernel_to_index.size();
+            red.kernel_to_index.push_back(v);
+        }
+    }
+    red.kernel.assign(red.kernel_to_index.size(), {});
+    for (size_t k = 0; k < red.kernel_to_index.size(); k++) {
+        for (int u : graph[red.kernel_to_index[k]]) {
+            if (alive[u]) red.kernel[k].push_back(index_to_kernel[u]);
+        }
+    }
+}
+
+// Map a clique of the reduced graph back to the input graph and count it
+void reportReducedClique(const Reduction& red, vector<int> C) {
+    if (C.size() <= 2 && red.suppressed.count(C)) return;
+    size_t base = C.size();
+    for (size_t i = 0; i < base; i++) {
+        const vector<int>& t = red.twins[C[i]];
+        C.insert(C.end(), t.begin(), t.end());
+    }
+    recordClique(C);
+}
+
 // Helper function to report a maximal clique
 void reportMaximalClique(const vector<int>& R) {
+    if (!local_to_global && !active_reduction) {
+        recordClique(R);
+        return;
+    }
+    
+    vector<int> C = R;
+    if (local_to_global) {
+        for (int& v : C) v = (*local_to_global)[v];
+    }
+    if (active_reduction) {
+        for (int& v : C) v = active_reduction->kernel_to_index[v];
+        sort(C.begin(), C.end());
+        reportReducedClique(*active_reduction, C);
+        return;
+    }
+    recordClique(C);
+}
+
+void recordClique(const vector<int>& R) {
+    if (clique_sink) {
+        clique_sink->push_back(R);
+        return;
+    }
+    
     // Increment clique counter
     total_cliques++;
     
+    if (top_k > 0 && R.size() > topKBound()) {
+        top_cliques.push(R);
+        if ((int)top_cliques.size() > top_k) top_cliques.pop();
+    }
+    
     // Check if this is the largest clique so far
     if (R.size() > max_clique_size) {
         max_clique_size = R.size();
         largest_clique = R;
     }
     
-    // Print progress after every 100,000 cliques
-    if (total_cliques % 100000 == 0) {
-        cout << "Progress: " << total_cliques << " maximal cliques found so far. Current largest size: " 
-             << max_clique_size << endl;
-    }
+    progress.cliques.fetch_add(1, memory_order_relaxed);
+    if (R.size() >= clique_size_count.size()) clique_size_count.resize(R.size() + 1, 0);
+    clique_size_count[R.size()]++;
     
-    // Uncomment this if you want to print all maximal cliques (could be a lot!)
-    /*
-    for (int v : R) {
-        cout << index_to_node[v] << " "; // Use original node IDs
+    // Print the clique as sorted original node IDs
+    if (clique_out) {
+        vector<int> ids;
+        for (int v : R) ids.push_back(index_to_node[v]);
+        sort(ids.begin(), ids.end());
+        for (size_t i = 0; i < ids.size(); i++) *clique_out << (i ? " " : "") << ids[i];
+        *clique_out << '\n';
     }
-    cout << endl;
-    */
-}
-
-// Function to check if a vertex is a neighbor efficiently
-bool isNeighbor(const vector<int>& neighbors, int vertex) {
-    // Binary search since we keep adjacency lists sorted
-    return binary_search(neighbors.begin(), neighbors.end(), vertex);
 }
 
 // Modified BronKerboschPivot that uses references and iterators to avoid copying
 void BronKerboschPivot(vector<int> P, vector<int>& R, vector<int> X, 
                        const Graph& graph) {
+    // In top-k mode, give up on branches that cannot beat the smallest kept clique
+    if (top_k > 0 && R.size() + P.size() <= topKBound()) {
+        return;
+    }
+    
     if (P.empty() && X.empty()) {
         reportMaximalClique(R);
         return;
@@ -164,12 +428,318 @@ void BronKerboschPivot(vector<int> P, vector<int>& R, vector<int> X,
     }
 }
 
+// Order in which the root subproblems (positions in the degeneracy ordering)
+// are visited. Top-k mode starts from the highest core numbers so that large
+// cliques are found early and the bound tightens quickly.
+vector<int> rootSchedule(const vector<int>& ordering, const vector<int>& core) {
+    vector<int> roots(ordering.size());
+    iota(roots.begin(), roots.end(), 0);
+    if (top_k > 0) {
+        stable_sort(roots.begin(), roots.end(), [&](int a, int b) {
+            return core[ordering[a]] > core[ordering[b]];
+        });
+    }
+    return roots;
+}
+
+// Number of neighbors per independently decodable block of a compressed list
+const int COMPRESSED_BLOCK = 64;
+
+// Adjacency lists in CSR form with delta-gap varint encoding. Each list is cut
+// into blocks of COMPRESSED_BLOCK neighbors; the first neighbor of a block is
+// kept verbatim in block_first, so any block can be decoded on its own.
+// The arrays are placed according to bigmem_flags (huge pages, NUMA interleave).
+struct CompressedGraph {
+    vector<int, BigAllocator<int>> degree;             // Degree of each vertex
+    vector<size_t, BigAllocator<size_t>> vertex_block; // Vertex -> index of its first block (n+1 entries)
+    vector<size_t, BigAllocator<size_t>> block_offset; // Block -> byte offset of its gaps in data
+    vector<int, BigAllocator<int>> block_first;        // Block -> first neighbor in the block
+    vector<uint8_t, BigAllocator<uint8_t>> data;       // Varint-encoded gaps
+
+    int size() const { return degree.size(); }
+
+    size_t bytes() const {
+        return degree.size() * sizeof(int) + vertex_block.size() * sizeof(size_t) +
+               block_offset.size() * sizeof(size_t) + block_first.size() * sizeof(int) + data.size();
+    }
+
+    // Append the neighbors in block b (holding count neighbors) to out
+    void decodeBlock(size_t b, int count, vector<int>& out) const {
+        const uint8_t* p = data.data() + block_offset[b];
+        int v = block_first[b];
+        out.push_back(v);
+        for (int i = 1; i < count; i++) {
+            unsigned gap = 0;
+            int shift = 0;
+            while (*p & 0x80) {
+                gap |= (unsigned)(*p++ & 0x7f) << shift;
+                shift += 7;
+            }
+            gap |= (unsigned)(*p++) << shift;
+            v += gap;
+            out.push_back(v);
+        }
+    }
+
+    // Replace out with the sorted neighbors of v
+    void decode(int v, vector<int>& out) const {
+        out.clear();
+        int remaining = degree[v];
+        for (size_t b = vertex_block[v]; b < vertex_block[v + 1]; b++) {
+            int count = min(remaining, COMPRESSED_BLOCK);
+            decodeBlock(b, count, out);
+            remaining -= count;
+        }
+    }
+
+    // Edge test that decodes only the block that could contain v into buf
+    bool hasEdge(int u, int v, vector<int>& buf) const {
+        size_t first = vertex_block[u], last = vertex_block[u + 1];
+        auto it = upper_bound(block_first.begin() + first, block_first.begin() + last, v);
+        if (it == block_first.begin() + first) return false;
+        size_t b = (it - block_first.begin()) - 1;
+        int count = min(degree[u] - (int)(b - first) * COMPRESSED_BLOCK, COMPRESSED_BLOCK);
+        buf.clear();
+        decodeBlock(b, count, buf);
+        return binary_search(buf.begin(), buf.end(), v);
+    }
+    
+    // Encode the sorted list [first, last) as the neighbors of the next vertex
+    template <typename It>
+    void append(It first, It last) {
+        degree.push_back(last - first);
+        vertex_block.push_back(block_first.size());
+        for (It it = first; it != last; ++it) {
+            if ((it - first) % COMPRESSED_BLOCK == 0) {
+                block_first.push_back(*it);
+                block_offset.push_back(data.size());
+                continue;
+            }
+            unsigned gap = *it - *(it - 1);
+            while (gap >= 0x80) {
+                data.push_back((gap & 0x7f) | 0x80);
+                gap >>= 7;
+            }
+            data.push_back(gap);
+        }
+    }
+    
+    // Close vertex_block after the last append
+    void finish() {
+        vertex_block.push_back(block_first.size());
+    }
+};
+
+// Encode the graph, releasing each adjacency list once it has been encoded
+CompressedGraph compressGraph(Graph& graph) {
+    int n = graph.size();
+    CompressedGraph cg;
+    cg.degree.reserve(n);
+    cg.vertex_block.reserve(n + 1);
+    
+    for (int v = 0; v < n; v++) {
+        cg.append(graph[v].begin(), graph[v].end());
+        vector<int>().swap(graph[v]);
+    }
+    cg.finish();
+    
+    cg.data.shrink_to_fit();
+    cg.block_first.shrink_to_fit();
+    cg.block_offset.shrink_to_fit();
+    return cg;
+}
+
+// Encode a CSR graph (see build_csr). A sizing pass lets every array be
+// allocated once at its final size, so the CSR and the encoding are the only
+// copies of the adjacency that ever coexist.
+CompressedGraph compressCSR(unsigned n, const unsigned* cd, const unsigned* adj) {
+    size_t blocks = 0, bytes = 0;
+    for (unsigned v = 0; v < n; v++) {
+        blocks += (cd[v + 1] - cd[v] + COMPRESSED_BLOCK - 1) / COMPRESSED_BLOCK;
+        for (unsigned i = cd[v]; i < cd[v + 1]; i++) {
+            if ((i - cd[v]) % COMPRESSED_BLOCK == 0) continue;
+            for (unsigned gap = adj[i] - adj[i - 1]; gap >= 0x80; gap >>= 7) bytes++;
+            bytes++;
+        }
+    }
+    
+    CompressedGraph cg;
+    cg.degree.reserve(n);
+    cg.vertex_block.reserve(n + 1);
+    cg.block_first.reserve(blocks);
+    cg.block_offset.reserve(blocks);
+    cg.data.reserve(bytes);
+    for (unsigned v = 0; v < n; v++) {
+        cg.append(adj + cd[v], adj + cd[v + 1]);
+    }
+    cg.finish();
+    return cg;
+}
+
+// Degeneracy ordering and core numbers of a CSR graph with the bucket method
+// of Batagelj and Zaversnik: vertices sit in an array sorted by current
+// degree, and removing a vertex moves each later neighbor one bucket down in
+// O(1). Uses four int arrays of n entries and no per-vertex containers.
+vector<int> degeneracyOrderingCSR(unsigned n, const unsigned* cd, const unsigned* adj, vector<int>* core) {
+    vector<int> degree(n), bucket_start, pos(n), ordering(n);
+    int max_degree = 0;
+    for (unsigned v = 0; v < n; v++) {
+        degree[v] = cd[v + 1] - cd[v];
+        max_degree = max(max_degree, degree[v]);
+    }
+    
+    // Counting sort of the vertices by degree
+    bucket_start.assign(max_degree + 1, 0);
+    for (unsigned v = 0; v < n; v++) bucket_start[degree[v]]++;
+    for (int d = 0, start = 0; d <= max_degree; d++) {
+        int count = bucket_start[d];
+        bucket_start[d] = start;
+        start += count;
+    }
+    for (unsigned v = 0; v < n; v++) {
+        pos[v] = bucket_start[degree[v]]++;
+        ordering[pos[v]] = v;
+    }
+    for (int d = max_degree; d > 0; d--) bucket_start[d] = bucket_start[d - 1];
+    bucket_start[0] = 0;
+    
+    // Take vertices in order; degree[v] becomes the core number of v
+    for (unsigned i = 0; i < n; i++) {
+        int v = ordering[i];
+        for (unsigned j = cd[v]; j < cd[v + 1]; j++) {
+            int u = adj[j];
+            if (degree[u] > degree[v]) {
+                // Swap u with the first vertex of its bucket, then shrink the bucket
+                int du = degree[u], pu = pos[u];
+                int pw = bucket_start[du], w = ordering[pw];
+                if (u != w) {
+                    pos[u] = pw;
+                    ordering[pu] = w;
+                    pos[w] = pu;
+                    ordering[pw] = u;
+                }
+                bucket_start[du]++;
+                degree[u]--;
+            }
+        }
+    }
+    
+    if (core) core->assign(degree.begin(), degree.end());
+    return ordering;
+}
+
+// Approximate heap footprint of the adjacency lists
+size_t graphBytes(const Graph& graph) {
+    size_t bytes = graph.size() * sizeof(vector<int>);
+    for (const auto& adj : graph) bytes += adj.capacity() * sizeof(int);
+    return bytes;
+}
+
+// Read access to the neighbor lists of a plain or compressed graph, for
+// extractRoot. PROBE_COST is the rough cost of one hasEdge test.
+struct ListAdjacency {
+    const Graph& graph;
+    static const int PROBE_COST = 32;
+    
+    int degree(int u) const { return graph[u].size(); }
+    const vector<int>& neighbors(int u, vector<int>&) const { return graph[u]; }
+    bool hasEdge(int u, int v, vector<int>&) const { return isNeighbor(graph[u], v); }
+};
+
+struct CompressedAdjacency {
+    const CompressedGraph& cg;
+    static const int PROBE_COST = COMPRESSED_BLOCK;
+    
+    int degree(int u) const { return cg.degree[u]; }
+    const vector<int>& neighbors(int u, vector<int>& buf) const {
+        cg.decode(u, buf);
+        return buf;
+    }
+    bool hasEdge(int u, int v, vector<int>& buf) const { return cg.hasEdge(u, v, buf); }
+};
+
+// Root subproblem of a vertex vi, as a small graph on its neighborhood
+struct LocalSubproblem {
+    Graph local;         // Graph induced by N(vi), in local indices
+    vector<int> mapping; // Local -> global index
+    vector<int> P, X;    // Neighbors later / earlier in the ordering
+    long long edges = 0; // Summed local degree
+};
+
+// Extract the root subproblem of vi, the vertex at position i of the
+// ordering, whose sorted neighbors are nbrs. Local vertex m = |nbrs| stands
+// for vi itself; it only ever appears in R. global_to_local must be all -1
+// and is left that way. A neighbor whose list is much longer than m (a hub)
+// is not scanned; instead the m candidates are probed with hasEdge.
+template <typename Adjacency>
+LocalSubproblem extractRoot(const Adjacency& adjacency, int vi, int i, const vector<int>& nbrs,
+                            const vector<int>& orderingIndex, vector<int>& global_to_local, vector<int>& buf) {
+    int m = nbrs.size();
+    LocalSubproblem sub;
+    sub.local.resize(m + 1);
+    sub.mapping = nbrs;
+    sub.mapping.push_back(vi);
+    
+    for (int j = 0; j < m; j++) global_to_local[nbrs[j]] = j;
+    for (int j = 0; j < m; j++) {
+        int u = nbrs[j];
+        if ((long long)m * Adjacency::PROBE_COST < adjacency.degree(u)) {
+            for (int x = 0; x < m; x++) {
+                if (x != j && adjacency.hasEdge(u, nbrs[x], buf)) sub.local[j].push_back(x);
+            }
+        } else {
+            for (int w : adjacency.neighbors(u, buf)) {
+                if (global_to_local[w] >= 0) sub.local[j].push_back(global_to_local[w]);
+            }
+        }
+        sub.edges += sub.local[j].size();
+        if (orderingIndex[u] > i) sub.P.push_back(j);
+        else sub.X.push_back(j);
+    }
+    for (int u : nbrs) global_to_local[u] = -1;
+    return sub;
+}
+
+// Degeneracy driver over a compressed graph. Each root subproblem decodes only
+// the neighborhoods of vi's neighbors into a small local graph and runs the
+// usual BronKerboschPivot on it.
+void BronKerboschDegeneracyCompressed(const CompressedGraph& cg, const vector<int>& ordering,
+                                      const vector<int>& core) {
+    int n = cg.size();
+    
+    vector<int> orderingIndex(n);
+    for (int i = 0; i < n; i++) {
+        orderingIndex[ordering[i]] = i;
+    }
+    
+    vector<int> global_to_local(n, -1);
+    vector<int> nbrs, buf;
+    
+    long long work = 0;
+    for (int d : cg.degree) work += d;
+    beginRoots(n, n + work / 2);
+    
+    CompressedAdjacency adjacency{cg};
+    for (int i : rootSchedule(ordering, core)) {
+        int vi = ordering[i];
+        cg.decode(vi, nbrs);
+        LocalSubproblem sub = extractRoot(adjacency, vi, i, nbrs, orderingIndex, global_to_local, buf);
+        
+        vector<int> R = {(int)nbrs.size()};
+        local_to_global = &sub.mapping;
+        BronKerboschPivot(sub.P, R, sub.X, sub.local);
+        local_to_global = nullptr;
+        finishRoot(sub.P.size() + 1);
+    }
+}
+
 // Main algorithm as shown in Fig. 4
 void BronKerboschDegeneracy(const Graph& graph) {
     int n = graph.size();
     
     // Get degeneracy ordering
-    vector<int> ordering = degeneracyOrdering(graph);
+    vector<int> core;
+    vector<int> ordering = degeneracyOrdering(graph, &core);
     
     // Create ordering index map for O(1) lookup
     vector<int> orderingIndex(n);
@@ -177,8 +747,10 @@ void BronKerboschDegeneracy(const Graph& graph) {
         orderingIndex[ordering[i]] = i;
     }
     
+    beginRoots(n, rootWork(graph));
+    
     // Process each vertex in degeneracy order
-    for (int i = 0; i < n; i++) {
+    for (int i : rootSchedule(ordering, core)) {
         int vi = ordering[i];
         
         // P = Γ(vi) ∩ {vi+1, ..., vn-1}
@@ -204,130 +776,1006 @@ void BronKerboschDegeneracy(const Graph& graph) {
         
         // Call BronKerboschPivot
         BronKerboschPivot(P, R, X, graph);
+        finishRoot(P.size() + 1);
     }
 }
 
-// Read graph from file with proper handling of non-sequential node IDs
-pair<Graph, vector<int>> readGraph(const string& filename) {
+// Largest subproblem handled by the single-word kernel
+const int WORD_KERNEL_MAX = 64;
+// Edge density from which the bitset kernel beats sorted-list intersections
+const double BITSET_KERNEL_DENSITY = 0.25;
+
+// Kernels the hybrid driver can dispatch a root subproblem to
+enum KernelPath { PATH_SPARSE, PATH_BITSET, PATH_WORD };
+const char* KERNEL_PATH_NAMES[] = {"sparse", "bitset", "word"};
+
+// BronKerboschPivot for subproblems of at most 64 vertices: P, X and every
+// adjacency row fit in one machine word
+void BronKerboschWord(uint64_t P, vector<int>& R, uint64_t X, const vector<uint64_t>& adj) {
+    if (top_k > 0 && R.size() + __builtin_popcountll(P) <= topKBound()) {
+        return;
+    }
+    if (!P && !X) {
+        reportMaximalClique(R);
+        return;
+    }
+    
+    int pivot = -1, max_connections = -1;
+    for (uint64_t m = P | X; m; m &= m - 1) {
+        int u = __builtin_ctzll(m);
+        int connections = __builtin_popcountll(P & adj[u]);
+        if (connections > max_connections) {
+            max_connections = connections;
+            pivot = u;
+        }
+    }
+    
+    for (uint64_t cand = P & ~adj[pivot]; cand; cand &= cand - 1) {
+        int v = __builtin_ctzll(cand);
+        uint64_t bit = 1ULL << v;
+        R.push_back(v);
+        BronKerboschWord(P & adj[v], R, X & adj[v], adj);
+        R.pop_back();
+        P &= ~bit;
+        X |= bit;
+    }
+}
+
+// BronKerboschPivot over multi-word bitsets for dense subproblems; row u of
+// adj occupies words [u * W, (u + 1) * W)
+void BronKerboschBitset(const vector<uint64_t>& P0, vector<int>& R, const vector<uint64_t>& X0,
+                        const vector<uint64_t>& adj, int W) {
+    auto count = [](const vector<uint64_t>& s) {
+        size_t c = 0;
+        for (uint64_t w : s) c += __builtin_popcountll(w);
+        return c;
+    };
+    if (top_k > 0 && R.size() + count(P0) <= topKBound()) {
+        return;
+    }
+    
+    bool empty = true;
+    for (int w = 0; w < W && empty; w++) empty = !P0[w] && !X0[w];
+    if (empty) {
+        reportMaximalClique(R);
+        return;
+    }
+    
+    int pivot = -1, max_connections = -1;
+    for (int w = 0; w < W; w++) {
+        for (uint64_t m = P0[w] | X0[w]; m; m &= m - 1) {
+            int u = w * 64 + __builtin_ctzll(m);
+            int connections = 0;
+            for (int x = 0; x < W; x++) connections += __builtin_popcountll(P0[x] & adj[u * W + x]);
+            if (connections > max_connections) {
+                max_connections = connections;
+                pivot = u;
+            }
+        }
+    }
+    
+    vector<uint64_t> P = P0, X = X0, new_P(W), new_X(W);
+    for (int w = 0; w < W; w++) {
+        for (uint64_t cand = P0[w] & ~adj[pivot * W + w]; cand; cand &= cand - 1) {
+            int v = w * 64 + __builtin_ctzll(cand);
+            for (int x = 0; x < W; x++) {
+                new_P[x] = P[x] & adj[v * W + x];
+                new_X[x] = X[x] & adj[v * W + x];
+            }
+            R.push_back(v);
+            BronKerboschBitset(new_P, R, new_X, adj, W);
+            R.pop_back();
+            P[w] &= ~(1ULL << (v & 63));
+            X[w] |= 1ULL << (v & 63);
+        }
+    }
+}
+
+// Original node ID of a vertex of the graph being enumerated
+int originalId(int v) {
+    if (active_reduction) v = active_reduction->kernel_to_index[v];
+    return index_to_node[v];
+}
+
+// Degeneracy driver that extracts each root subproblem into a local graph,
+// measures it and hands it to the kernel expected to be fastest: the
+// single-word kernel for tiny subproblems, the bitset kernel for dense ones
+// and the sorted-list recursion otherwise. One line per subproblem is written
+// to log if given.
+void BronKerboschHybrid(const Graph& graph, ostream* log) {
+    int n = graph.size();
+    
+    vector<int> core;
+    vector<int> ordering = degeneracyOrdering(graph, &core);
+    vector<int> orderingIndex(n);
+    for (int i = 0; i < n; i++) {
+        orderingIndex[ordering[i]] = i;
+    }
+    
+    vector<int> global_to_local(n, -1), buf;
+    ListAdjacency adjacency{graph};
+    long long path_count[3] = {0, 0, 0};
+    if (log) *log << "root\tsize\tlater\tdensity\tpath\tmicroseconds\n";
+    beginRoots(n, rootWork(graph));
+    
+    for (int i : rootSchedule(ordering, core)) {
+        int vi = ordering[i];
+        int m = graph[vi].size();
+        LocalSubproblem sub = extractRoot(adjacency, vi, i, graph[vi], orderingIndex, global_to_local, buf);
+        const Graph& local = sub.local;
+        const vector<int>& P = sub.P;
+        const vector<int>& X = sub.X;
+        
+        double density = m > 1 ? sub.edges / (double(m) * (m - 1)) : 1.0;
+        KernelPath path = m <= WORD_KERNEL_MAX ? PATH_WORD
+                        : density >= BITSET_KERNEL_DENSITY ? PATH_BITSET : PATH_SPARSE;
+        
+        vector<int> R = {m};
+        local_to_global = &sub.mapping;
+        auto start = chrono::steady_clock::now();
+        
+        if (path == PATH_WORD) {
+            vector<uint64_t> adj(m);
+            for (int j = 0; j < m; j++) {
+                for (int u : local[j]) adj[j] |= 1ULL << u;
+            }
+            uint64_t Pw = 0, Xw = 0;
+            for (int j : P) Pw |= 1ULL << j;
+            for (int j : X) Xw |= 1ULL << j;
+            BronKerboschWord(Pw, R, Xw, adj);
+        } else if (path == PATH_BITSET) {
+            int W = (m + 63) / 64;
+            vector<uint64_t> adj((size_t)m * W), Pb(W), Xb(W);
+            for (int j = 0; j < m; j++) {
+                for (int u : local[j]) adj[(size_t)j * W + u / 64] |= 1ULL << (u & 63);
+            }
+            for (int j : P) Pb[j / 64] |= 1ULL << (j & 63);
+            for (int j : X) Xb[j / 64] |= 1ULL << (j & 63);
+            BronKerboschBitset(Pb, R, Xb, adj, W);
+        } else {
+            BronKerboschPivot(P, R, X, local);
+        }
+        
+        local_to_global = nullptr;
+        finishRoot(P.size() + 1);
+        path_count[path]++;
+        if (log) {
+            auto us = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+            *log << originalId(vi) << "\t" << m << "\t" << P.size() << "\t" << density << "\t"
+                 << KERNEL_PATH_NAMES[path] << "\t" << us << "\n";
+        }
+    }
+    
+    cout << "Hybrid dispatch: " << path_count[PATH_WORD] << " word, " << path_count[PATH_BITSET]
+         << " bitset, " << path_count[PATH_SPARSE] << " sparse subproblems" << endl;
+}
+
+// Internal index of an original node ID, or -1 if the node is not in the graph
+int nodeIndex(long long node) {
+    if (node < INT_MIN || node > INT_MAX) return -1;
+    auto it = lower_bound(index_to_node.begin(), index_to_node.end(), node);
+    if (it == index_to_node.end() || *it != node) return -1;
+    return it - index_to_node.begin();
+}
+
+// Sorted intersection of two adjacency lists
+vector<int> intersectNeighbors(const vector<int>& a, const vector<int>& b) {
+    vector<int> out;
+    set_intersection(a.begin(), a.end(), b.begin(), b.end(), back_inserter(out));
+    return out;
+}
+
+// Count k-cliques whose vertices all lie in cand, extending a clique of size depth
+long long countKCliques(const Graph& graph, const vector<int>& cand, int depth, int k) {
+    if (depth == k) return 1;
+    long long count = 0;
+    for (size_t i = 0; i < cand.size(); i++) {
+        // Only extend with later candidates so each clique is counted once
+        vector<int> next;
+        for (size_t j = i + 1; j < cand.size(); j++) {
+            if (isNeighbor(graph[cand[i]], cand[j])) next.push_back(cand[j]);
+        }
+        if (depth + 1 + (int)next.size() >= k) {
+            count += countKCliques(graph, next, depth + 1, k);
+        }
+    }
+    return count;
+}
+
+// Read seed vertices (original node IDs separated by whitespace, '#' starts a
+// comment line) and return their internal indices, sorted and without
+// duplicates. IDs that are not in the graph are skipped with a warning.
+vector<int> readSeeds(const string& filename) {
     ifstream file(filename);
     if (!file.is_open()) {
         throw runtime_error("Could not open file: " + filename);
     }
     
+    vector<int> seeds;
+    int unknown = 0;
     string line;
-    int n = 0;
-    
-    // Skip comments and get number of nodes
     while (getline(file, line)) {
-        if (line[0] != '#') break;
+        if (!line.empty() && line[0] == '#') continue;
+        istringstream iss(line);
+        int node;
+        while (iss >> node) {
+            int v = nodeIndex(node);
+            if (v < 0) unknown++;
+            else seeds.push_back(v);
+        }
+    }
+    if (unknown > 0) {
+        cerr << "Warning: " << unknown << " seed IDs are not in the graph" << endl;
+    }
+    
+    sort(seeds.begin(), seeds.end());
+    seeds.erase(unique(seeds.begin(), seeds.end()), seeds.end());
+    return seeds;
+}
+
+// Enumerate exactly the maximal cliques containing at least one seed. Such a
+// clique lies in H = G[N[S]], the graph induced by the seeds and their
+// neighbors, and is maximal in G exactly when it is maximal in H: a vertex
+// extending it is adjacent to its seed and so lies in H as well. H is run
+// through the usual degeneracy driver, skipping roots w whose N[w] holds no
+// seed and dropping the cliques without one, so only H is ever touched.
+void BronKerboschSeeded(const Graph& graph, const vector<int>& seeds) {
+    // Vertices of H in global index order; local index = position
+    vector<int> vertices = seeds;
+    for (int s : seeds) vertices.insert(vertices.end(), graph[s].begin(), graph[s].end());
+    sort(vertices.begin(), vertices.end());
+    vertices.erase(unique(vertices.begin(), vertices.end()), vertices.end());
+    int h = vertices.size();
+    auto localIndex = [&](int v) {
+        auto it = lower_bound(vertices.begin(), vertices.end(), v);
+        return (it != vertices.end() && *it == v) ? int(it - vertices.begin()) : -1;
+    };
+    
+    vector<bool> is_seed(h, false);
+    for (int s : seeds) is_seed[localIndex(s)] = true;
+    
+    Graph H(h);
+    long long h_edges = 0;
+    for (int j = 0; j < h; j++) {
+        for (int u : graph[vertices[j]]) {
+            int k = localIndex(u);
+            if (k >= 0) H[j].push_back(k);
+        }
+        h_edges += H[j].size();
+    }
+    cout << "Seed neighborhood: " << h << " nodes, " << h_edges / 2 << " edges" << endl;
+    
+    vector<int> ordering = degeneracyOrdering(H);
+    vector<int> orderingIndex(h);
+    for (int i = 0; i < h; i++) {
+        orderingIndex[ordering[i]] = i;
+    }
+    
+    // Roots that can reach a seed, with their later (P) and earlier (X) neighbors
+    auto nearSeed = [&](int w) {
+        if (is_seed[w]) return true;
+        for (int u : H[w]) {
+            if (is_seed[u]) return true;
+        }
+        return false;
+    };
+    vector<int> roots;
+    long long work = 0;
+    for (int i = 0; i < h; i++) {
+        int w = ordering[i];
+        if (!nearSeed(w)) continue;
+        roots.push_back(w);
+        for (int u : H[w]) {
+            if (orderingIndex[u] > i) work++;
+        }
+        work++;
+    }
+    beginRoots(roots.size(), work);
+    
+    vector<vector<int>> found;
+    for (int w : roots) {
+        vector<int> P, X;
+        for (int u : H[w]) {
+            if (orderingIndex[u] > orderingIndex[w]) P.push_back(u);
+            else X.push_back(u);
+        }
+        
+        vector<int> R = {w};
+        found.clear();
+        clique_sink = &found;
+        local_to_global = &vertices;
+        BronKerboschPivot(P, R, X, H);
+        local_to_global = nullptr;
+        clique_sink = nullptr;
         
-        // Extract number of nodes from the comment
-        if (line.find("Nodes:") != string::npos) {
-            size_t pos = line.find("Nodes:") + 6;
-            while (pos < line.length() && line[pos] == ' ') pos++;
-            sscanf(line.c_str() + pos, "%d", &n);
+        for (const vector<int>& C : found) {
+            bool seeded = false;
+            for (int v : C) seeded = seeded || binary_search(seeds.begin(), seeds.end(), v);
+            if (seeded) recordClique(C);
+        }
+        finishRoot(P.size() + 1);
+    }
+}
+
+// Cached answers of the query server, keyed by normalized query. Entries are
+// kept in recency order and the least recently used one is evicted once more
+// than QUERY_CACHE_MAX are held.
+const size_t QUERY_CACHE_MAX = 4096;
+list<pair<string, string>> query_lru;
+unordered_map<string, list<pair<string, string>>::iterator> query_cache;
+
+string formatClique(vector<int> C) {
+    for (int& v : C) v = index_to_node[v];
+    sort(C.begin(), C.end());
+    string out;
+    for (int v : C) out += " " + to_string(v);
+    return out;
+}
+
+// Answer one query line of the server protocol (original node IDs):
+//   cliques V           maximal cliques containing V
+//   kcliques K V1 V2 .. number of K-cliques in the subgraph induced by V1 V2 ..
+//   maxclique U V       a largest clique containing the edge (U, V)
+string answerQuery(const Graph& graph, const string& line) {
+    istringstream iss(line);
+    string cmd;
+    iss >> cmd;
+    vector<long long> args;
+    long long a;
+    while (iss >> a) args.push_back(a);
+    
+    string key = cmd;
+    if (cmd == "kcliques" && !args.empty()) {
+        sort(args.begin() + 1, args.end());
+        args.erase(unique(args.begin() + 1, args.end()), args.end());
+    }
+    for (long long x : args) key += " " + to_string(x);
+    auto cached = query_cache.find(key);
+    if (cached != query_cache.end()) {
+        query_lru.splice(query_lru.begin(), query_lru, cached->second);
+        return cached->second->second;
+    }
+    
+    string answer;
+    if (cmd == "cliques" && args.size() == 1) {
+        int v = nodeIndex(args[0]);
+        if (v < 0) return "ERR unknown node\n";
+        
+        vector<vector<int>> found;
+        vector<int> R = {v};
+        clique_sink = &found;
+        BronKerboschPivot(graph[v], R, {}, graph);
+        clique_sink = nullptr;
+        
+        answer = "OK " + to_string(found.size()) + "\n";
+        for (const auto& C : found) answer += formatClique(C).substr(1) + "\n";
+    } else if (cmd == "kcliques" && args.size() >= 2) {
+        long long k = args[0];
+        vector<int> S;
+        for (size_t i = 1; i < args.size(); i++) {
+            int v = nodeIndex(args[i]);
+            if (v < 0) return "ERR unknown node\n";
+            S.push_back(v);
+        }
+        sort(S.begin(), S.end());
+        if (k < 1) return "ERR k must be positive\n";
+        long long count = k > (long long)S.size() ? 0 : countKCliques(graph, S, 0, k);
+        answer = "OK " + to_string(count) + "\n";
+    } else if (cmd == "maxclique" && args.size() == 2) {
+        int u = nodeIndex(args[0]), v = nodeIndex(args[1]);
+        if (u < 0 || v < 0) return "ERR unknown node\n";
+        if (!isNeighbor(graph[u], v)) return "ERR not an edge\n";
+        
+        vector<vector<int>> found;
+        vector<int> R = {u, v};
+        clique_sink = &found;
+        BronKerboschPivot(intersectNeighbors(graph[u], graph[v]), R, {}, graph);
+        clique_sink = nullptr;
+        
+        auto best = max_element(found.begin(), found.end(), [](const vector<int>& x, const vector<int>& y) {
+            return x.size() < y.size();
+        });
+        answer = "OK " + to_string(best->size()) + formatClique(*best) + "\n";
+    } else {
+        return "ERR unknown query\n";
+    }
+    
+    query_lru.emplace_front(key, answer);
+    query_cache[key] = query_lru.begin();
+    if (query_cache.size() > QUERY_CACHE_MAX) {
+        query_cache.erase(query_lru.back().first);
+        query_lru.pop_back();
+    }
+    return answer;
+}
+
+// Serve queries line by line from stdin until EOF or "quit"
+void serveStdin(const Graph& graph) {
+    string line;
+    while (getline(cin, line)) {
+        if (line == "quit") break;
+        if (line.empty()) continue;
+        cout << answerQuery(graph, line) << flush;
+    }
+}
+
+// Write all of data to a socket, retrying short writes. Returns false once the
+// client has gone away; MSG_NOSIGNAL keeps that from raising SIGPIPE.
+bool sendAll(int fd, const string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        sent += n;
+    }
+    return true;
+}
+
+// Serve queries on a local Unix socket, one client at a time
+void serveSocket(const Graph& graph, const string& path) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) throw runtime_error("Could not create socket");
+    
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path)) throw runtime_error("Socket path too long: " + path);
+    strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    
+    // Only a stale socket may be replaced; never delete anything else
+    struct stat st;
+    if (lstat(path.c_str(), &st) == 0) {
+        if (!S_ISSOCK(st.st_mode)) {
+            close(fd);
+            throw runtime_error("Socket path exists and is not a socket: " + path);
         }
+        unlink(path.c_str());
+    }
+    if (bind(fd, (sockaddr*)&addr, sizeof(addr)) < 0 || listen(fd, 8) < 0) {
+        close(fd);
+        throw runtime_error("Could not listen on socket: " + path);
     }
+    *status_out << "Listening on " << path << endl;
     
-    // First pass: collect all unique node IDs
-    set<int> unique_nodes;
+    bool running = true;
+    while (running) {
+        int client = accept(fd, nullptr, nullptr);
+        if (client < 0) {
+            // A client that gave up before being accepted is not an error;
+            // anything else (e.g. out of descriptors) would fail forever
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            string reason = strerror(errno);
+            close(fd);
+            unlink(path.c_str());
+            throw runtime_error("Could not accept on socket: " + reason);
+        }
+        
+        string pending;
+        char buf[4096];
+        ssize_t got;
+        bool connected = true;
+        while (running && connected && (got = read(client, buf, sizeof(buf))) > 0) {
+            pending.append(buf, got);
+            size_t nl;
+            while ((nl = pending.find('\n')) != string::npos) {
+                string line = pending.substr(0, nl);
+                pending.erase(0, nl + 1);
+                if (line == "quit") {
+                    running = false;
+                    break;
+                }
+                if (line.empty()) continue;
+                if (!sendAll(client, answerQuery(graph, line))) {
+                    connected = false;
+                    break;
+                }
+            }
+        }
+        close(client);
+    }
+    close(fd);
+    unlink(path.c_str());
+}
+
+// Read an edge list into CSR form (see build_csr) with consecutive node
+// indices; returns the original ID of every index. The edges are read once,
+// the distinct IDs are gathered in a buffer that is sorted and deduplicated
+// whenever it doubles, and the edge list is released as soon as build_csr has
+// scattered it.
+vector<int> readCSR(const string& filename, unsigned** cd, unsigned** adj) {
+    ifstream file(filename);
+    if (!file.is_open()) {
+        throw runtime_error("Could not open file: " + filename);
+    }
     
-    // Process the first non-comment line we already read
+    // Skip comments
+    string line;
+    while (getline(file, line)) {
+        if (line[0] != '#') break;
+    }
+    
+    // Collect the edges with original IDs
+    vector<pair<int, int>> edges;
     int u, v;
     if (sscanf(line.c_str(), "%d %d", &u, &v) == 2) {
-        unique_nodes.insert(u);
-        unique_nodes.insert(v);
+        edges.push_back({u, v});
     }
-    
-    // Read remaining edges and collect unique node IDs
     while (file >> u >> v) {
-        unique_nodes.insert(u);
-        unique_nodes.insert(v);
+        edges.push_back({u, v});
     }
     
-    // Create a mapping from original node IDs to consecutive indices
-    unordered_map<int, int> node_to_index;
+    // Map original node IDs to consecutive indices in ID order
     vector<int> index_to_node_map;
-    int index = 0;
-    for (int node : unique_nodes) {
-        node_to_index[node] = index;
-        index_to_node_map.push_back(node);
-        index++;
+    size_t distinct = 0;
+    auto compact = [&]() {
+        sort(index_to_node_map.begin(), index_to_node_map.end());
+        index_to_node_map.erase(unique(index_to_node_map.begin(), index_to_node_map.end()), index_to_node_map.end());
+        distinct = index_to_node_map.size();
+    };
+    for (const auto& e : edges) {
+        index_to_node_map.push_back(e.first);
+        index_to_node_map.push_back(e.second);
+        if (index_to_node_map.size() >= 2 * distinct + (1 << 16)) compact();
     }
+    compact();
+    index_to_node_map.shrink_to_fit();
+    
+    int n = index_to_node_map.size();
+    *status_out << "Unique nodes count: " << n << endl;
     
-    // Use the actual number of unique nodes
-    n = unique_nodes.size();
+    parallel_for(0, edges.size(), 0, [&](size_t i) {
+        auto index = [&](int node) {
+            return int(lower_bound(index_to_node_map.begin(), index_to_node_map.end(), node) - index_to_node_map.begin());
+        };
+        edges[i] = {index(edges[i].first), index(edges[i].second)};
+    }, 1 << 16);
     
-    cout << "Unique nodes count: " << n << endl;
+    // Build sorted, duplicate-free adjacency lists in parallel; self-loops
+    // keep their node but never become part of an adjacency list
+    build_csr(n, edges.size(), [&edges](size_t i) {
+        return pair<unsigned, unsigned>(edges[i].first, edges[i].second);
+    }, cd, adj, 0, [&edges]() { vector<pair<int, int>>().swap(edges); });
+    
+    return index_to_node_map;
+}
+
+// Read graph from file with proper handling of non-sequential node IDs
+pair<Graph, vector<int>> readGraph(const string& filename) {
+    unsigned *cd, *adj;
+    vector<int> index_to_node_map = readCSR(filename, &cd, &adj);
+    int n = index_to_node_map.size();
     
     // Create graph with n nodes
     Graph graph(n);
+    parallel_for(0, n, 0, [&](size_t v) {
+        graph[v].assign(adj + cd[v], adj + cd[v + 1]);
+    });
+    bigfree(adj, (size_t)cd[n] * sizeof(unsigned));
+    bigfree(cd, (n + 1) * sizeof(unsigned));
     
-    // Reset file to beginning and skip comments again
-    file.clear();
-    file.seekg(0);
-    while (getline(file, line) && line[0] == '#');
+    return {move(graph), move(index_to_node_map)};
+}
+
+// Edge with a timestamp, endpoints as internal indices
+struct TemporalEdge {
+    int u, v;
+    long long t;
+};
+
+// Read "u v t" lines (t in any integer unit), skipping comments and self-loops.
+// Sets the global node mapping and returns the edges sorted by time.
+vector<TemporalEdge> readTemporalEdges(const string& filename) {
+    ifstream file(filename);
+    if (!file.is_open()) {
+        throw runtime_error("Could not open file: " + filename);
+    }
     
-    // Process the first non-comment line again
-    if (sscanf(line.c_str(), "%d %d", &u, &v) == 2) {
-        graph[node_to_index[u]].push_back(node_to_index[v]);
-        // For undirected graphs, add both directions
-        graph[node_to_index[v]].push_back(node_to_index[u]);
+    vector<TemporalEdge> edges;
+    string line;
+    while (getline(file, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        TemporalEdge e;
+        if (sscanf(line.c_str(), "%d %d %lld", &e.u, &e.v, &e.t) != 3) {
+            throw runtime_error("Expected \"u v timestamp\" in line: " + line);
+        }
+        if (e.u != e.v) edges.push_back(e);
     }
     
-    // Read remaining edges
-    while (file >> u >> v) {
-        graph[node_to_index[u]].push_back(node_to_index[v]);
-        // For undirected graphs, add both directions
-        graph[node_to_index[v]].push_back(node_to_index[u]);
+    index_to_node.clear();
+    for (const auto& e : edges) {
+        index_to_node.push_back(e.u);
+        index_to_node.push_back(e.v);
     }
+    sort(index_to_node.begin(), index_to_node.end());
+    index_to_node.erase(unique(index_to_node.begin(), index_to_node.end()), index_to_node.end());
+    for (auto& e : edges) {
+        e.u = nodeIndex(e.u);
+        e.v = nodeIndex(e.v);
+    }
+    
+    stable_sort(edges.begin(), edges.end(), [](const TemporalEdge& a, const TemporalEdge& b) {
+        return a.t < b.t;
+    });
+    return edges;
+}
+
+// Maximal cliques over sliding windows [start, start + window), advancing by
+// step. One degeneracy ordering of the union graph is kept for all windows, so
+// the cliques of root vi depend only on the subgraph induced by N[vi]. When an
+// edge (a, b) appears or disappears, only the roots a, b and their common
+// neighbors (before or after the change) are recomputed; the cached cliques of
+// every other root carry over. Each window reports the cliques that appeared
+// and disappeared relative to the previous one.
+void BronKerboschWindows(const vector<TemporalEdge>& edges, long long window, long long step) {
+    int n = index_to_node.size();
+    if (edges.empty()) return;
     
-    // Remove duplicate edges and sort adjacency lists
+    // Ordering of the union graph over the whole time span
+    Graph graph(n);
+    for (const auto& e : edges) {
+        graph[e.u].push_back(e.v);
+        graph[e.v].push_back(e.u);
+    }
     for (auto& adj : graph) {
         sort(adj.begin(), adj.end());
         adj.erase(unique(adj.begin(), adj.end()), adj.end());
     }
+    vector<int> ordering = degeneracyOrdering(graph);
+    vector<int> orderingIndex(n);
+    for (int i = 0; i < n; i++) {
+        orderingIndex[ordering[i]] = i;
+    }
+    
+    // From here on graph holds the current window
+    for (auto& adj : graph) adj.clear();
+    unordered_map<uint64_t, int> multiplicity;
+    auto key = [](int a, int b) {
+        return (uint64_t)min(a, b) << 32 | (uint32_t)max(a, b);
+    };
+    
+    vector<vector<vector<int>>> root_cliques(n);
+    vector<bool> dirty(n, false);
+    vector<int> dirty_roots;
+    auto markDirty = [&](int v) {
+        if (!dirty[v]) {
+            dirty[v] = true;
+            dirty_roots.push_back(v);
+        }
+    };
+    auto markEdge = [&](int a, int b) {
+        markDirty(a);
+        markDirty(b);
+        for (int c : intersectNeighbors(graph[a], graph[b])) markDirty(c);
+    };
+    
+    size_t added = 0, removed = 0;
+    long long current = 0, recomputed = 0;
+    int windows = 0;
+    for (long long start = edges.front().t; start <= edges.back().t; start += step) {
+        long long end = start + window;
+        
+        // Edges whose presence changes with this window
+        vector<pair<int, int>> toggled;
+        for (; removed < added && edges[removed].t < start; removed++) {
+            if (--multiplicity[key(edges[removed].u, edges[removed].v)] == 0) {
+                toggled.push_back({edges[removed].u, edges[removed].v});
+            }
+        }
+        for (; added < edges.size() && edges[added].t < end; added++) {
+            if (edges[added].t < start) {
+                removed++;
+                continue;
+            }
+            if (multiplicity[key(edges[added].u, edges[added].v)]++ == 0) {
+                toggled.push_back({edges[added].u, edges[added].v});
+            }
+        }
+        
+        // Roots affected in the old graph, then apply the changes, then roots
+        // affected in the new graph
+        for (auto [a, b] : toggled) markEdge(a, b);
+        for (auto [a, b] : toggled) {
+            bool present = multiplicity[key(a, b)] > 0;
+            for (auto [x, y] : {make_pair(a, b), make_pair(b, a)}) {
+                auto it = lower_bound(graph[x].begin(), graph[x].end(), y);
+                bool there = it != graph[x].end() && *it == y;
+                if (present && !there) graph[x].insert(it, y);
+                if (!present && there) graph[x].erase(it);
+            }
+            if (!present) multiplicity.erase(key(a, b));
+        }
+        for (auto [a, b] : toggled) markEdge(a, b);
+        
+        vector<vector<int>> appeared, disappeared;
+        for (int vi : dirty_roots) {
+            dirty[vi] = false;
+            
+            vector<vector<int>> found;
+            if (!graph[vi].empty()) {
+                vector<int> P, X;
+                for (int u : graph[vi]) {
+                    if (orderingIndex[u] > orderingIndex[vi]) P.push_back(u);
+                    else X.push_back(u);
+                }
+                vector<int> R = {vi};
+                clique_sink = &found;
+                BronKerboschPivot(P, R, X, graph);
+                clique_sink = nullptr;
+                for (auto& C : found) sort(C.begin(), C.end());
+                sort(found.begin(), found.end());
+            }
+            recomputed++;
+            
+            vector<vector<int>>& old = root_cliques[vi];
+            set_difference(found.begin(), found.end(), old.begin(), old.end(), back_inserter(appeared));
+            set_difference(old.begin(), old.end(), found.begin(), found.end(), back_inserter(disappeared));
+            current += (long long)found.size() - (long long)old.size();
+            old.swap(found);
+        }
+        dirty_roots.clear();
+        windows++;
+        
+        cout << "Window [" << start << ", " << end << "): " << current << " maximal cliques, +"
+             << appeared.size() << " appeared, -" << disappeared.size() << " disappeared" << endl;
+        for (const auto& C : appeared) cout << "+" << formatClique(C) << endl;
+        for (const auto& C : disappeared) cout << "-" << formatClique(C) << endl;
+    }
     
-    return {graph, index_to_node_map};
+    cout << "Windows: " << windows << ", root subproblems recomputed: " << recomputed
+         << " of " << (long long)windows * n << endl;
+}
+
+// Value of a numeric option, or -1 unless text is a whole non-negative number
+long long parseCount(const char* text) {
+    char* end;
+    errno = 0;
+    long long value = strtoll(text, &end, 10);
+    if (end == text || *end != '\0' || errno == ERANGE || value < 0) return -1;
+    return value;
+}
+
+// Same for options that take a number of seconds
+double parseSeconds(const char* text) {
+    char* end;
+    errno = 0;
+    double value = strtod(text, &end);
+    if (end == text || *end != '\0' || errno == ERANGE || !(value >= 0)) return -1;
+    return value;
+}
+
+int invalidValue(const string& option, const char* text) {
+    cerr << "Invalid value for " << option << ": " << text << " (expected a non-negative number)" << endl;
+    return 1;
 }
 
 int main(int argc, char* argv[]) {
     if (argc < 2) {
-        cerr << "Usage: " << argv[0] << " <input_file>" << endl;
+        cerr << "Usage: " << argv[0] << " <input_file> [--reduce] [--compressed] [--hybrid [log]] [--top-k N] [--seeds file] [--serve [socket]]"
+             << " [--progress SECONDS] [--progress-json] [--thp] [--hugepages] [--interleave]"
+             << " [--window W [--step S]]" << endl;
         return 1;
     }
     
     string filename = argv[1];
+    bool reduce = false;
+    bool compressed = false;
+    bool serve = false;
+    string socket_path;
+    bool hybrid = false;
+    string hybrid_log;
+    string seeds_file;
+    string cliques_file;
+    double progress_interval = 1.0;
+    bool progress_json = false;
+    long long window = 0, step = 0;
+    for (int i = 2; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--reduce") {
+            reduce = true;
+        } else if (arg == "--compressed") {
+            compressed = true;
+        } else if (arg == "--top-k" && i + 1 < argc) {
+            long long value = parseCount(argv[++i]);
+            if (value < 0 || value > INT_MAX) return invalidValue(arg, argv[i]);
+            top_k = value;
+        } else if (arg == "--hybrid") {
+            hybrid = true;
+            if (i + 1 < argc && argv[i + 1][0] != '-') hybrid_log = argv[++i];
+        } else if (arg == "--progress" && i + 1 < argc) {
+            progress_interval = parseSeconds(argv[++i]);
+            if (progress_interval < 0) return invalidValue(arg, argv[i]);
+        } else if (arg == "--progress-json") {
+            progress_json = true;
+        } else if (arg == "--thp") {
+            bigmem_flags |= BIGMEM_THP;
+        } else if (arg == "--hugepages") {
+            bigmem_flags |= BIGMEM_HUGETLB;
+        } else if (arg == "--interleave") {
+            bigmem_flags |= BIGMEM_INTERLEAVE;
+        } else if (arg == "--seeds" && i + 1 < argc) {
+            seeds_file = argv[++i];
+        } else if (arg == "--cliques" && i + 1 < argc) {
+            cliques_file = argv[++i];
+        } else if (arg == "--window" && i + 1 < argc) {
+            window = parseCount(argv[++i]);
+            if (window < 0) return invalidValue(arg, argv[i]);
+        } else if (arg == "--step" && i + 1 < argc) {
+            step = parseCount(argv[++i]);
+            if (step < 0) return invalidValue(arg, argv[i]);
+        } else if (arg == "--serve") {
+            serve = true;
+            if (i + 1 < argc && argv[i + 1][0] != '-') socket_path = argv[++i];
+        } else {
+            cerr << "Unknown option: " << arg << endl;
+            return 1;
+        }
+    }
+    if (top_k > 0 && reduce) {
+        // Twin expansion changes clique sizes after the bound has been applied
+        cerr << "--top-k cannot be combined with --reduce" << endl;
+        return 1;
+    }
+    if (hybrid && compressed) {
+        cerr << "--hybrid extracts its subproblems from the uncompressed graph" << endl;
+        return 1;
+    }
+    if (!seeds_file.empty() && (reduce || compressed || hybrid)) {
+        cerr << "--seeds runs on the plain graph and cannot be combined with --reduce, --compressed or --hybrid" << endl;
+        return 1;
+    }
+    if (serve && (reduce || compressed || hybrid || top_k > 0 || !seeds_file.empty() || !cliques_file.empty())) {
+        cerr << "--serve answers queries on the plain graph and takes no other options" << endl;
+        return 1;
+    }
+    if (window > 0 && (reduce || compressed || hybrid || serve || top_k > 0 || !seeds_file.empty() ||
+                       !cliques_file.empty())) {
+        cerr << "--window reads a temporal edge list and takes no other enumeration options" << endl;
+        return 1;
+    }
+    if (step <= 0) step = window;
     
     try {
-        // Get graph and mapping
-        auto [graph, node_mapping] = readGraph(filename);
-        index_to_node = node_mapping; // Set global mapping
+        if (window > 0) {
+            vector<TemporalEdge> edges = readTemporalEdges(filename);
+            cout << "Temporal graph loaded: " << index_to_node.size() << " nodes, "
+                 << edges.size() << " timestamped edges" << endl;
+            BronKerboschWindows(edges, window, step);
+            return 0;
+        }
+        
+        if (serve) status_out = &cerr;
+        
+        // Get graph and mapping. Plain --compressed encodes straight from the
+        // CSR and never builds the uncompressed Graph.
+        Graph graph;
+        unsigned *cd = nullptr, *adj = nullptr;
+        if (compressed && !reduce) {
+            index_to_node = readCSR(filename, &cd, &adj);
+        } else {
+            vector<int> node_mapping;
+            tie(graph, node_mapping) = readGraph(filename);
+            index_to_node = move(node_mapping); // Set global mapping
+        }
+        
+        *status_out << "Graph loaded: " << index_to_node.size() << " nodes" << endl;
+        
+        if (serve) {
+            if (socket_path.empty()) serveStdin(graph);
+            else serveSocket(graph, socket_path);
+            return 0;
+        }
         
-        cout << "Graph loaded: " << graph.size() << " nodes" << endl;
         cout << "Starting maximal clique enumeration..." << endl;
         
+        vector<int> seeds;
+        if (!seeds_file.empty()) {
+            seeds = readSeeds(seeds_file);
+            cout << "Seeds: " << seeds.size() << " nodes" << endl;
+        }
+        
+        ofstream cliques;
+        if (!cliques_file.empty()) {
+            cliques.open(cliques_file);
+            if (!cliques.is_open()) throw runtime_error("Could not open file: " + cliques_file);
+            clique_out = &cliques;
+        }
+        
         // Reset statistics
         total_cliques = 0;
         max_clique_size = 0;
+        progress.reset();
+        ProgressMonitor monitor(progress, progress_interval, progress_json);
         
         // Start timer
         clock_t start = clock();
         
-        BronKerboschDegeneracy(graph);
+        Reduction red;
+        Graph* target = &graph;
+        if (reduce) {
+            reduceGraph(graph, red);
+            cout << "Reduction: " << red.twins_collapsed << " twins collapsed, "
+                 << red.vertices_peeled << " vertices peeled, kernel has "
+                 << red.kernel.size() << " nodes" << endl;
+            
+            for (const vector<int>& C : red.peeled_cliques) {
+                reportReducedClique(red, C);
+            }
+            active_reduction = &red;
+            target = &red.kernel;
+        }
+        
+        if (!seeds_file.empty()) {
+            BronKerboschSeeded(graph, seeds);
+        } else if (compressed && cd) {
+            unsigned n = index_to_node.size();
+            size_t csr_bytes = ((size_t)n + 1 + cd[n]) * sizeof(unsigned);
+            vector<int> core;
+            vector<int> ordering = degeneracyOrderingCSR(n, cd, adj, &core);
+            CompressedGraph cg = compressCSR(n, cd, adj);
+            bigfree(adj, (size_t)cd[n] * sizeof(unsigned));
+            bigfree(cd, (n + 1) * sizeof(unsigned));
+            cout << "Compressed adjacency: " << cg.bytes() << " bytes (CSR: "
+                 << csr_bytes << " bytes)" << endl;
+            BronKerboschDegeneracyCompressed(cg, ordering, core);
+        } else if (compressed) {
+            vector<int> core;
+            vector<int> ordering = degeneracyOrdering(*target, &core);
+            size_t list_bytes = graphBytes(*target);
+            CompressedGraph cg = compressGraph(*target);
+            cout << "Compressed adjacency: " << cg.bytes() << " bytes (lists: "
+                 << list_bytes << " bytes)" << endl;
+            BronKerboschDegeneracyCompressed(cg, ordering, core);
+        } else if (hybrid) {
+            ofstream log;
+            if (!hybrid_log.empty()) {
+                log.open(hybrid_log);
+                if (!log.is_open()) throw runtime_error("Could not open file: " + hybrid_log);
+            }
+            BronKerboschHybrid(*target, log.is_open() ? &log : nullptr);
+        } else {
+            BronKerboschDegeneracy(*target);
+        }
+        active_reduction = nullptr;
+        monitor.stop();
         
         // End timer
         clock_t end = clock();
         double time_taken = double(end - start) / CLOCKS_PER_SEC;
         
         // Print statistics
-        cout << "Total maximal cliques found: " << total_cliques << endl;
+        if (top_k > 0) {
+            cout << "Maximal cliques reached (others pruned by top-k bound): " << total_cliques << endl;
+        } else {
+            cout << "Total maximal cliques found: " << total_cliques << endl;
+        }
         cout << "Size of largest clique: " << max_clique_size << endl;
+        if (top_k == 0) {
+            cout << "Maximal cliques by size:" << endl;
+            for (size_t k = 1; k < clique_size_count.size(); k++) {
+                if (clique_size_count[k] > 0) cout << "  " << k << ": " << clique_size_count[k] << endl;
+            }
+        }
         cout << "Largest clique (original node IDs): ";
         for (int v : largest_clique) {
             cout << index_to_node[v] << " ";  // Map back to original node IDs
         }
         cout << endl;
+        
+        if (top_k > 0) {
+            vector<vector<int>> best;
+            while (!top_cliques.empty()) {
+                best.push_back(top_cliques.top());
+                top_cliques.pop();
+            }
+            cout << "Top " << best.size() << " largest maximal cliques (original node IDs):" << endl;
+            for (auto it = best.rbegin(); it != best.rend(); ++it) {
+                cout << "  [" << it->size() << "] ";
+                for (int v : *it) {
+                    cout << index_to_node[v] << " ";
+                }
+                cout << endl;
+            }
+        }
         cout << "Time taken: " << time_taken << " seconds" << endl;
         
     } catch (const exception& e) {
@@ -0,0 +1,136 @@
+#ifndef BIGMEM_H
+#define BIGMEM_H
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Placement of the large, long-lived arrays (CSR adjacency). Arrays of at
+// least BIGMEM_THRESHOLD bytes are mapped directly and, depending on
+// bigmem_flags, backed by huge pages and/or interleaved over all NUMA nodes.
+// Smaller arrays go through malloc as before.
+//
+// Per-thread scratch is not handled here: threads allocate and first-touch
+// their own buffers, which the kernel's default local policy already places
+// on the thread's node.
+
+#define BIGMEM_THP 1        // ask for transparent huge pages (madvise)
+#define BIGMEM_HUGETLB 2    // explicit 2MB pages (MAP_HUGETLB), THP if none are reserved
+#define BIGMEM_INTERLEAVE 4 // interleave pages over all online NUMA nodes
+
+#define BIGMEM_PAGE (2UL << 20)
+#define BIGMEM_THRESHOLD BIGMEM_PAGE
+
+inline unsigned bigmem_flags = 0;
+
+// Bitmask of the online NUMA nodes, 0 if it cannot be determined
+inline unsigned long bigmem_online_nodes()
+{
+    FILE *f = fopen("/sys/devices/system/node/online", "r");
+    if (!f)
+        return 0;
+    unsigned long mask = 0;
+    unsigned a, b;
+    int c;
+    while (fscanf(f, "%u", &a) == 1)
+    {
+        b = a;
+        if ((c = fgetc(f)) == '-')
+        {
+            if (fscanf(f, "%u", &b) != 1)
+                break;
+            c = fgetc(f);
+        }
+        for (; a <= b && a < 8 * sizeof(mask); a++)
+            mask |= 1UL << a;
+        if (c != ',')
+            break;
+    }
+    fclose(f);
+    return mask;
+}
+
+inline size_t bigmem_length(size_t bytes)
+{
+    return (bytes + BIGMEM_PAGE - 1) & ~(BIGMEM_PAGE - 1);
+}
+
+inline void *bigalloc(size_t bytes)
+{
+    if (bytes < BIGMEM_THRESHOLD)
+        return malloc(bytes);
+
+    size_t len = bigmem_length(bytes);
+    void *p = MAP_FAILED;
+#ifdef MAP_HUGETLB
+    if (bigmem_flags & BIGMEM_HUGETLB)
+        p = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+    if (p == MAP_FAILED)
+    {
+        p = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED)
+            return NULL;
+#ifdef MADV_HUGEPAGE
+        if (bigmem_flags & (BIGMEM_THP | BIGMEM_HUGETLB))
+            madvise(p, len, MADV_HUGEPAGE);
+#endif
+    }
+
+    // must happen before the pages are first touched
+    if (bigmem_flags & BIGMEM_INTERLEAVE)
+    {
+        unsigned long nodes = bigmem_online_nodes();
+        if (nodes & (nodes - 1)) // more than one node
+        {
+            const int MPOL_INTERLEAVE_ = 3;
+            syscall(SYS_mbind, p, len, MPOL_INTERLEAVE_, &nodes, 8 * sizeof(nodes), 0);
+        }
+    }
+    return p;
+}
+
+inline void bigfree(void *p, size_t bytes)
+{
+    if (p == NULL)
+        return;
+    if (bytes < BIGMEM_THRESHOLD)
+        free(p);
+    else
+        munmap(p, bigmem_length(bytes));
+}
+
+// STL allocator on top of bigalloc, for arrays kept in std::vector
+template <typename T>
+struct BigAllocator
+{
+    typedef T value_type;
+
+    BigAllocator() = default;
+    template <typename U>
+    BigAllocator(const BigAllocator<U> &) {}
+
+    T *allocate(size_t n)
+    {
+        void *p = bigalloc(n * sizeof(T));
+        if (p == NULL)
+            throw std::bad_alloc();
+        return static_cast<T *>(p);
+    }
+
+    void deallocate(T *p, size_t n)
+    {
+        bigfree(p, n * sizeof(T));
+    }
+
+    template <typename U>
+    bool operator==(const BigAllocator<U> &) const { return true; }
+    template <typename U>
+    bool operator!=(const BigAllocator<U> &) const { return false; }
+};
+
+#endif
@@ -5,12 +5,15 @@ This program iterates over all k-cliques.
 This is an implementation of the 1985 paper of Chiba And Nishizeki "Arboricity and subgraph listing".
 
 To compile:
-"g++ Arboricity.cpp -O3 -o Arboricity".
+"g++ Arboricity.cpp -O3 -pthread -o Arboricity".
 
 To execute:
-"./Arboricity edgelist.txt k".
+"./Arboricity edgelist.txt [--threads T] [--thp] [--hugepages] [--interleave]".
 "edgelist.txt" should contain the graph: one edge on each line separated by a space.
 Will print the number of k-cliques.
+With --threads, triangles and 4-cliques are counted edge-parallel on T threads.
+--thp, --hugepages and --interleave back the adjacency arrays with transparent
+huge pages, explicit 2MB pages or pages interleaved over the NUMA nodes.
 */
 
 #include <cstdlib>
@@ -24,10 +27,16 @@ Will print the number of k-cliques.
 #include <unordered_map>
 #include <vector>
 #include <iomanip>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include "bigmem.h"
+#include "csr_builder.h"
 
 #define hi(i) printf("hi #%u\n", i);
 
 #define NLINKS 100000000 // maximum number of edges for memory allocation, will increase if needed
+#define EDGE_CHUNK 256    // oriented edges claimed at once by an edge-parallel worker
 
 typedef struct
 {
@@ -48,12 +57,21 @@ typedef struct
     edge *edges; // list of edges
 
     unsigned *ns;  // ns[l]: number of nodes in G_l
-    unsigned **d;  // d[l]: degrees of G_l
+    unsigned **d;  // d[l][i]: degree in G_l of node sub[l][i]
     unsigned *cd;  // cumulative degree: (start with 0) length=n+1
     unsigned *adj; // list of neighbors with lower degree
 
     unsigned char *lab; // lab[i] label of node i
     unsigned **sub;     // sub[l]: nodes in G_l
+    unsigned *pos;      // pos[i]: position of node i in sub[lab[i]]
+    unsigned **ppos;    // ppos[l][i]: position of node sub[l][i] in sub[l+1]
+
+    // scratch buffers of arg_bucket_sort
+    unsigned *c;    // count
+    unsigned *cc;   // cummulative count
+    unsigned *key2; // sorted nodes
+    unsigned *val2; // degrees of sorted nodes
+    unsigned *pp2;  // ppos of sorted nodes
 
     // Add fields to maintain the mapping between original IDs and internal indices
     std::vector<unsigned> index_to_node; // Mapping from internal index to original node ID
@@ -67,12 +85,21 @@ void freespecialsparse(specialsparse *g, unsigned char k)
     {
         free(g->d[i]);
         free(g->sub[i]);
+        free(g->ppos[i]);
     }
     free(g->d);
     free(g->sub);
-    free(g->cd);
-    free(g->adj);
-    free(g);
+    free(g->ppos);
+    free(g->pos);
+    free(g->lab);
+    free(g->c);
+    free(g->cc);
+    free(g->key2);
+    free(g->val2);
+    free(g->pp2);
+    bigfree(g->cd, (g->n + 1) * sizeof(unsigned));
+    bigfree(g->adj, 2 * g->e * sizeof(unsigned));
+    delete g;
 }
 
 // Compute the maximum of three unsigned integers.
@@ -82,9 +109,23 @@ inline unsigned int max3(unsigned int a, unsigned int b, unsigned int c)
     return (a > c) ? a : c;
 }
 
+// Read the next edge, skipping '#' comment lines; returns 0 at end of file
+int read_edge(FILE *file, unsigned *s, unsigned *t)
+{
+    char line[1024];
+    while (fgets(line, sizeof(line), file))
+    {
+        if (line[0] == '#')
+            continue;
+        if (sscanf(line, "%u %u", s, t) == 2)
+            return 1;
+    }
+    return 0;
+}
+
 // Improved readedgelist function that handles non-sequential node IDs
 specialsparse *readedgelist(const char *edgelist) {
-    specialsparse *g = (specialsparse*)malloc(sizeof(specialsparse));
+    specialsparse *g = new specialsparse(); // holds a std::vector, so it must be constructed
     FILE *file;
 
     file = fopen(edgelist, "r");
@@ -96,7 +137,7 @@ specialsparse *readedgelist(const char *edgelist) {
     // First pass: collect all unique node IDs
     std::set<unsigned> unique_nodes;
     unsigned s, t;
-    while (fscanf(file, "%u %u", &s, &t) == 2) {
+    while (read_edge(file, &s, &t)) {
         unique_nodes.insert(s);
         unique_nodes.insert(t);
     }
@@ -119,37 +160,29 @@ specialsparse *readedgelist(const char *edgelist) {
     // Reset file to beginning for second pass
     rewind(file);
     
-    // Second pass: read edges and store them with mapped indices
+    // Second pass: read edges and store them with mapped indices. Duplicate
+    // and reversed edges are merged later by the CSR builder in mkspecial.
     unsigned e1 = NLINKS;
     g->edges = (edge*)malloc(e1 * sizeof(edge));
     g->e = 0;
     
-    // Use a set to efficiently detect duplicates
-    std::set<std::pair<unsigned, unsigned>> edge_set;
-    
-    while (fscanf(file, "%u %u", &s, &t) == 2) {
+    while (read_edge(file, &s, &t)) {
         unsigned mapped_s = node_to_index[s];
         unsigned mapped_t = node_to_index[t];
         
-        // Ensure s < t to treat (s, t) and (t, s) as the same edge
-        if (mapped_s > mapped_t) {
-            std::swap(mapped_s, mapped_t);
+        // Self-loops keep their node but are not edges of any clique
+        if (mapped_s == mapped_t) {
+            continue;
         }
         
-        // Check if the edge already exists
-        auto edge_pair = std::make_pair(mapped_s, mapped_t);
-        if (edge_set.find(edge_pair) == edge_set.end()) {
-            edge_set.insert(edge_pair);
-            
-            // Add edge to our list
-            g->edges[g->e].s = mapped_s;
-            g->edges[g->e].t = mapped_t;
-            g->e++;
-            
-            if (g->e == e1) {
-                e1 += NLINKS;
-                g->edges = (edge*)realloc(g->edges, e1 * sizeof(edge));
-            }
+        // Add edge to our list
+        g->edges[g->e].s = mapped_s;
+        g->edges[g->e].t = mapped_t;
+        g->e++;
+        
+        if (g->e == e1) {
+            e1 += NLINKS;
+            g->edges = (edge*)realloc(g->edges, e1 * sizeof(edge));
         }
     }
     fclose(file);
@@ -157,8 +190,6 @@ specialsparse *readedgelist(const char *edgelist) {
     // Resize the edges array to the actual number of edges
     g->edges = (edge*)realloc(g->edges, g->e * sizeof(edge));
     
-    std::cout << "Graph loaded: " << g->n << " nodes, " << g->e << " edges" << std::endl;
-    
     return g;
 }
 
@@ -169,143 +200,170 @@ void mkspecial(specialsparse *g, unsigned char k)
     unsigned *d, *sub;
     unsigned char *lab;
 
-    d = (unsigned*)calloc(g->n, sizeof(unsigned));
-
-    for (i = 0; i < g->e; i++)
-    {
-        d[g->edges[i].s]++;
-        d[g->edges[i].t]++;
-    }
+    // parallel CSR build, which also merges duplicate edges
+    edge *edges = g->edges;
+    g->e = build_csr(g->n, g->e, [edges](size_t i) { return std::make_pair(edges[i].s, edges[i].t); },
+                     &g->cd, &g->adj) / 2;
+    free(g->edges);
+    std::cout << "Graph loaded: " << g->n << " nodes, " << g->e << " edges" << std::endl;
 
-    g->cd = (unsigned*)malloc((g->n + 1) * sizeof(unsigned));
+    d = (unsigned*)malloc(g->n * sizeof(unsigned));
     ns = 0;
-    g->cd[0] = 0;
     max = 0;
     sub = (unsigned*)malloc(g->n * sizeof(unsigned));
     lab = (unsigned char*)malloc(g->n * sizeof(unsigned char));
-    for (i = 1; i < g->n + 1; i++)
+    for (i = 0; i < g->n; i++)
     {
-        g->cd[i] = g->cd[i - 1] + d[i - 1];
-        if (d[i - 1] > 0)
+        d[i] = g->cd[i + 1] - g->cd[i];
+        if (d[i] > 0)
         {
-            max = (max > d[i - 1]) ? max : d[i - 1];
-            sub[ns] = i - 1;
+            max = (max > d[i]) ? max : d[i];
+            sub[ns] = i;
             ns++;
-            d[i - 1] = 0;
-            lab[i - 1] = k;
+            lab[i] = k;
         }
     }
 
-    g->adj = (unsigned*)malloc(2 * g->e * sizeof(unsigned));
-
-    for (i = 0; i < g->e; i++)
-    {
-        g->adj[g->cd[g->edges[i].s] + d[g->edges[i].s]++] = g->edges[i].t;
-        g->adj[g->cd[g->edges[i].t] + d[g->edges[i].t]++] = g->edges[i].s;
-    }
-    free(g->edges);
-
     g->ns = (unsigned*)malloc((k + 1) * sizeof(unsigned));
     g->ns[k] = ns;
 
+    // Level arrays are indexed by position in sub[l], so below the top level
+    // they only need room for the largest neighborhood
     g->d = (unsigned**)malloc((k + 1) * sizeof(unsigned*));
     g->sub = (unsigned**)malloc((k + 1) * sizeof(unsigned*));
+    g->ppos = (unsigned**)malloc((k + 1) * sizeof(unsigned*));
     for (i = 2; i < k; i++)
     {
-        g->d[i] = (unsigned*)malloc(g->n * sizeof(unsigned));
+        g->d[i] = (unsigned*)malloc(max * sizeof(unsigned));
         g->sub[i] = (unsigned*)malloc(max * sizeof(unsigned));
+        g->ppos[i] = (unsigned*)malloc(max * sizeof(unsigned));
+    }
+    g->sub[k] = (unsigned*)realloc(sub, ns * sizeof(unsigned));
+    g->d[k] = (unsigned*)malloc(ns * sizeof(unsigned));
+    g->ppos[k] = NULL;
+    g->pos = (unsigned*)malloc(g->n * sizeof(unsigned));
+    for (i = 0; i < ns; i++)
+    {
+        g->d[k][i] = d[g->sub[k][i]];
+        g->pos[g->sub[k][i]] = i;
     }
-    g->d[k] = d;
-    g->sub[k] = sub;
+    free(d);
 
     g->lab = lab;
+
+    // degrees never exceed max, and no level holds more than ns nodes
+    g->c = (unsigned*)malloc((max + 1) * sizeof(unsigned));
+    g->cc = (unsigned*)malloc((max + 1) * sizeof(unsigned));
+    g->key2 = (unsigned*)malloc(ns * sizeof(unsigned));
+    g->val2 = (unsigned*)malloc(ns * sizeof(unsigned));
+    g->pp2 = (unsigned*)malloc(ns * sizeof(unsigned));
 }
 
-void arg_bucket_sort(unsigned *key, unsigned n, unsigned *val)
+// Sort sub[l] by degree in G_l, carrying the per-position level data along
+void arg_bucket_sort(specialsparse *g, unsigned l)
 {
-    unsigned i, j;
-    static unsigned *c = NULL, *cc = NULL, *key2 = NULL;
-    if (c == NULL)
+    unsigned i, j, p, n = g->ns[l];
+    unsigned *key = g->sub[l], *val = g->d[l], *pp = g->ppos[l];
+    unsigned maxval = 0;
+
+    for (i = 0; i < n; i++)
     {
-        c = (unsigned*)malloc(n * sizeof(unsigned));    // count
-        cc = (unsigned*)malloc(n * sizeof(unsigned));   // cummulative count
-        key2 = (unsigned*)malloc(n * sizeof(unsigned)); // sorted array
+        maxval = (maxval > val[i]) ? maxval : val[i];
     }
-    memset(c, 0, n * sizeof(unsigned));
+    memset(g->c, 0, (maxval + 1) * sizeof(unsigned));
 
     for (i = 0; i < n; i++)
     {
-        (c[val[key[i]]])++;
+        (g->c[val[i]])++;
     }
-    cc[0] = 0;
-    for (i = 1; i < n; i++)
+    g->cc[0] = 0;
+    for (i = 1; i < maxval + 1; i++)
     {
-        cc[i] = cc[i - 1] + c[i - 1];
-        c[i - 1] = 0;
+        g->cc[i] = g->cc[i - 1] + g->c[i - 1];
+        g->c[i - 1] = 0;
     }
-    c[i - 1] = 0;
+    g->c[maxval] = 0;
 
     for (i = 0; i < n; i++)
     {
-        j = val[key[i]];
-        key2[cc[j] + c[j]++] = key[i];
+        j = val[i];
+        p = g->cc[j] + g->c[j]++;
+        g->key2[p] = key[i];
+        g->val2[p] = val[i];
+        if (pp != NULL)
+        {
+            g->pp2[p] = pp[i];
+        }
     }
 
-    // Copy sorted data back to original array
+    // Copy sorted data back to original arrays
     for (i = 0; i < n; i++) {
-        key[i] = key2[i];
+        key[i] = g->key2[i];
+        val[i] = g->val2[i];
+        g->pos[key[i]] = i;
+    }
+    if (pp != NULL)
+    {
+        memcpy(pp, g->pp2, n * sizeof(unsigned));
     }
 }
 
-void kclique(unsigned l, specialsparse *g, unsigned long long *n)
+// Base case of the recursion: list the edges of G_2
+void kclique_edges(specialsparse *g, unsigned long long *n)
 {
-    unsigned i, j, k, end, u, v, w;
+    unsigned i, j, end, u, v;
 
-    if (l == 2)
-    {
-        for (i = 0; i < g->ns[2]; i++)
-        { // list all edges
-            u = g->sub[2][i];
-            end = g->cd[u] + g->d[2][u];
-            for (j = g->cd[u]; j < end; j++)
+    for (i = 0; i < g->ns[2]; i++)
+    { // list all edges
+        u = g->sub[2][i];
+        end = g->cd[u] + g->d[2][i];
+        for (j = g->cd[u]; j < end; j++)
+        {
+            v = g->adj[j];
+            if (v < u)
             {
-                v = g->adj[j];
-                if (v < u)
-                {
-                    (*n)++; // listing here!!!
-                }
+                (*n)++; // listing here!!!
             }
         }
-        return;
     }
+}
+
+// One level l > 2 of the recursion; next() lists the cliques of G_{l-1}.
+// Inlined into both the runtime and the compile-time recursions below.
+template <typename Next>
+inline void kclique_level(unsigned l, specialsparse *g, Next next)
+{
+    unsigned i, j, k, end, u, v, w;
 
-    arg_bucket_sort(g->sub[l], g->ns[l], g->d[l]);
+    arg_bucket_sort(g, l);
 
     for (i = 0; i < g->ns[l]; i++)
     {
         u = g->sub[l][i];
         g->ns[l - 1] = 0;
-        end = g->cd[u] + g->d[l][u];
+        end = g->cd[u] + g->d[l][i];
         for (j = g->cd[u]; j < end; j++)
         { // relabeling nodes and forming U'.
             v = g->adj[j];
             if (g->lab[v] == l)
             {
                 g->lab[v] = l - 1;
-                g->sub[l - 1][g->ns[l - 1]++] = v;
-                g->d[l - 1][v] = 0; // new degrees
+                g->ppos[l - 1][g->ns[l - 1]] = g->pos[v];
+                g->pos[v] = g->ns[l - 1];
+                g->sub[l - 1][g->ns[l - 1]] = v;
+                g->d[l - 1][g->ns[l - 1]++] = 0; // new degrees
             }
         }
         for (j = 0; j < g->ns[l - 1]; j++)
         { // reodering adjacency list and computing new degrees
             v = g->sub[l - 1][j];
-            end = g->cd[v] + g->d[l][v];
+            end = g->cd[v] + g->d[l][g->ppos[l - 1][j]];
             for (k = g->cd[v]; k < end; k++)
             {
                 w = g->adj[k];
                 if (g->lab[w] == l - 1)
                 {
-                    g->d[l - 1][w]++;
+                    g->d[l - 1][g->pos[w]]++;
                 }
                 else
                 {
@@ -315,13 +373,14 @@ void kclique(unsigned l, specialsparse *g, unsigned long long *n)
             }
         }
 
-        kclique(l - 1, g, n);
+        next();
 
         for (j = 0; j < g->ns[l - 1]; j++)
         { // moving u to last position in each entry of the adjacency list
             v = g->sub[l - 1][j];
             g->lab[v] = l;
-            end = g->cd[v] + g->d[l - 1][v];
+            g->pos[v] = g->ppos[l - 1][j];
+            end = g->cd[v] + g->d[l - 1][j];
             for (k = g->cd[v]; k < end; k++)
             {
                 w = g->adj[k];
@@ -329,24 +388,299 @@ void kclique(unsigned l, specialsparse *g, unsigned long long *n)
                 {
                     g->adj[k] = g->adj[--end];
                     g->adj[end] = w;
-                    g->d[l - 1][v]--;
+                    g->d[l - 1][j]--;
                     break;
                 }
             }
         }
         g->lab[u] = l + 1;
     }
+}
+
+void kclique(unsigned l, specialsparse *g, unsigned long long *n)
+{
+    if (l == 2)
+    {
+        kclique_edges(g, n);
+        return;
+    }
+    kclique_level(l, g, [&]() { kclique(l - 1, g, n); });
+}
+
+// kclique with the level known at compile time, so the whole recursion is
+// unrolled for the small k of common queries
+template <unsigned L>
+void kclique_fixed(specialsparse *g, unsigned long long *n)
+{
+    kclique_level(L, g, [&]() { kclique_fixed<L - 1>(g, n); });
+}
+
+template <>
+void kclique_fixed<2>(specialsparse *g, unsigned long long *n)
+{
+    kclique_edges(g, n);
+}
+
+// Graph with every edge oriented from lower to higher (degree, id) rank;
+// out-neighbor lists are sorted by node id
+typedef struct
+{
+    unsigned n;
+    unsigned *cd;  // cumulative out-degree: length=n+1
+    unsigned *adj; // out-neighbors
+} orientedsparse;
+
+orientedsparse *mkoriented(specialsparse *g)
+{
+    unsigned i, j, u, v;
+    orientedsparse *og = (orientedsparse*)malloc(sizeof(orientedsparse));
+    og->n = g->n;
+    og->cd = (unsigned*)bigalloc((g->n + 1) * sizeof(unsigned));
+
+    // edge (u, v) points to v if v ranks higher than u
+    auto higher = [g](unsigned u, unsigned v) {
+        unsigned du = g->cd[u + 1] - g->cd[u], dv = g->cd[v + 1] - g->cd[v];
+        return du < dv || (du == dv && u < v);
+    };
+
+    og->cd[0] = 0;
+    for (u = 0; u < g->n; u++)
+    {
+        og->cd[u + 1] = og->cd[u];
+        for (j = g->cd[u]; j < g->cd[u + 1]; j++)
+        {
+            if (higher(u, g->adj[j]))
+            {
+                og->cd[u + 1]++;
+            }
+        }
+    }
+
+    og->adj = (unsigned*)bigalloc(og->cd[g->n] * sizeof(unsigned));
+    for (u = 0; u < g->n; u++)
+    {
+        i = og->cd[u];
+        for (j = g->cd[u]; j < g->cd[u + 1]; j++)
+        {
+            v = g->adj[j];
+            if (higher(u, v))
+            {
+                og->adj[i++] = v;
+            }
+        }
+        std::sort(og->adj + og->cd[u], og->adj + og->cd[u + 1]);
+    }
+    return og;
+}
+
+void freeoriented(orientedsparse *og)
+{
+    bigfree(og->adj, og->cd[og->n] * sizeof(unsigned));
+    bigfree(og->cd, (og->n + 1) * sizeof(unsigned));
+    free(og);
+}
+
+// Size of the intersection of two sorted lists
+inline unsigned merge_count(const unsigned *a, unsigned na, const unsigned *b, unsigned nb)
+{
+    unsigned i = 0, j = 0, c = 0;
+    while (i < na && j < nb)
+    {
+        if (a[i] < b[j])
+            i++;
+        else if (a[i] > b[j])
+            j++;
+        else
+        {
+            c++;
+            i++;
+            j++;
+        }
+    }
+    return c;
+}
+
+// Dedicated triangle counter: every triangle is found exactly once, at its
+// lowest ranked node, by intersecting oriented out-neighbor lists
+unsigned long long triangles(specialsparse *g)
+{
+    unsigned u, v, j;
+    unsigned long long n = 0;
+    orientedsparse *og = mkoriented(g);
+
+    for (u = 0; u < og->n; u++)
+    {
+        for (j = og->cd[u]; j < og->cd[u + 1]; j++)
+        {
+            v = og->adj[j];
+            n += merge_count(og->adj + og->cd[u], og->cd[u + 1] - og->cd[u],
+                             og->adj + og->cd[v], og->cd[v + 1] - og->cd[v]);
+        }
+    }
 
-    return;
+    freeoriented(og);
+    return n;
+}
+
+// Load statistics of one edge-parallel worker
+typedef struct
+{
+    unsigned long long tasks; // oriented edges processed
+    double busy;              // seconds spent on tasks
+    double slowest;           // seconds spent on the slowest task
+} workerstats;
+
+// Count triangles (k = 3) or 4-cliques (k = 4) with one task per oriented edge
+// (u, v): the cliques found there are those extending u, v by nodes of
+// W = out(u) & out(v). Workers claim chunks of EDGE_CHUNK edges from a shared
+// cursor, so a few hub nodes cannot pin their whole neighborhood on one thread.
+unsigned long long edge_parallel_kcliques(specialsparse *g, unsigned char k, unsigned nthreads)
+{
+    orientedsparse *og = mkoriented(g);
+    unsigned m = og->cd[og->n];
+    std::atomic<unsigned> cursor(0);
+    std::vector<unsigned long long> counts(nthreads, 0);
+    std::vector<workerstats> stats(nthreads);
+    std::vector<std::thread> workers;
+
+    auto worker = [&](unsigned t) {
+        typedef std::chrono::steady_clock clk;
+        std::vector<unsigned> W; // common out-neighborhood, first touched by this thread so it stays on its node
+        unsigned long long n = 0;
+        workerstats st = {0, 0.0, 0.0};
+        unsigned begin, end, e, u, v, w, i, j;
+
+        while ((begin = cursor.fetch_add(EDGE_CHUNK, std::memory_order_relaxed)) < m)
+        {
+            end = std::min(begin + EDGE_CHUNK, m);
+            u = std::upper_bound(og->cd, og->cd + og->n + 1, begin) - og->cd - 1;
+            for (e = begin; e < end; e++)
+            {
+                while (og->cd[u + 1] <= e)
+                    u++;
+                v = og->adj[e];
+                clk::time_point start = clk::now();
+
+                W.clear();
+                for (i = og->cd[u], j = og->cd[v]; i < og->cd[u + 1] && j < og->cd[v + 1];)
+                {
+                    if (og->adj[i] < og->adj[j])
+                        i++;
+                    else if (og->adj[i] > og->adj[j])
+                        j++;
+                    else
+                    {
+                        W.push_back(og->adj[i]);
+                        i++;
+                        j++;
+                    }
+                }
+                if (k == 3)
+                {
+                    n += W.size();
+                }
+                else
+                {
+                    for (i = 0; i < W.size(); i++)
+                    {
+                        w = W[i];
+                        n += merge_count(og->adj + og->cd[w], og->cd[w + 1] - og->cd[w], W.data(), W.size());
+                    }
+                }
+
+                double took = std::chrono::duration<double>(clk::now() - start).count();
+                st.tasks++;
+                st.busy += took;
+                st.slowest = std::max(st.slowest, took);
+            }
+        }
+        counts[t] = n;
+        stats[t] = st;
+    };
+
+    for (unsigned t = 0; t < nthreads; t++)
+    {
+        workers.push_back(std::thread(worker, t));
+    }
+    unsigned long long n = 0;
+    double maxbusy = 0.0, sumbusy = 0.0;
+    for (unsigned t = 0; t < nthreads; t++)
+    {
+        workers[t].join();
+        n += counts[t];
+        maxbusy = std::max(maxbusy, stats[t].busy);
+        sumbusy += stats[t].busy;
+    }
+
+    for (unsigned t = 0; t < nthreads; t++)
+    {
+        std::cout << "[thread " << t << "] tasks: " << stats[t].tasks << ", busy: " << stats[t].busy
+                  << " s, slowest task: " << stats[t].slowest * 1e6 << " us" << std::endl;
+    }
+    if (sumbusy > 0)
+    {
+        std::cout << "[balance] max/mean busy time: " << maxbusy / (sumbusy / nthreads) << std::endl;
+    }
+
+    freeoriented(og);
+    return n;
+}
+
+// Count k-cliques, using the specialized kernels for small k and the
+// edge-parallel counter for k = 3, 4 when nthreads > 0
+unsigned long long count_kcliques(unsigned char k, specialsparse *g, unsigned nthreads)
+{
+    unsigned long long n = 0;
+    if (nthreads > 0 && (k == 3 || k == 4))
+    {
+        return edge_parallel_kcliques(g, k, nthreads);
+    }
+    switch (k)
+    {
+    case 3:
+        n = triangles(g);
+        break;
+    case 4:
+        kclique_fixed<4>(g, &n);
+        break;
+    case 5:
+        kclique_fixed<5>(g, &n);
+        break;
+    default:
+        kclique(k, g, &n);
+    }
+    return n;
 }
 
 int main(int argc, char **argv)
 {
     if (argc < 2) {
-        std::cerr << "Usage: " << argv[0] << " edgelist.txt" << std::endl;
+        std::cerr << "Usage: " << argv[0] << " edgelist.txt [--threads T] [--thp] [--hugepages] [--interleave]" << std::endl;
         return 1;
     }
 
+    unsigned nthreads = 0;
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            char *end;
+            long value = strtol(argv[++i], &end, 10);
+            if (end == argv[i] || *end != '\0' || value < 0 || value > 65536) {
+                std::cerr << "Invalid value for --threads: " << argv[i] << " (expected 0 to 65536)" << std::endl;
+                return 1;
+            }
+            nthreads = value;
+        } else if (strcmp(argv[i], "--thp") == 0) {
+            bigmem_flags |= BIGMEM_THP;
+        } else if (strcmp(argv[i], "--hugepages") == 0) {
+            bigmem_flags |= BIGMEM_HUGETLB;
+        } else if (strcmp(argv[i], "--interleave") == 0) {
+            bigmem_flags |= BIGMEM_INTERLEAVE;
+        } else {
+            std::cerr << "Unknown option: " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+
     unsigned long long* cliqueCount = NULL;
     unsigned max_k = 100;
     cliqueCount = (unsigned long long*)malloc((max_k + 1) * sizeof(unsigned long long));
@@ -372,8 +706,7 @@ int main(int argc, char **argv)
         }
         mkspecial(g, k);
         
-        n = 0;
-        kclique(k, g, &n);
+        n = count_kcliques(k, g, nthreads);
         
         if (k >= max_k) {
             max_k *= 2;
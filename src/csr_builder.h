@@ -0,0 +1,130 @@
+#ifndef CSR_BUILDER_H
+#define CSR_BUILDER_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "bigmem.h"
+
+// Number of worker threads used when the caller passes 0
+inline unsigned csr_default_threads()
+{
+    unsigned t = std::thread::hardware_concurrency();
+    return t > 0 ? t : 1;
+}
+
+// Run fn(i) for every i in [begin, end) on nthreads threads (0 = all cores).
+// Threads claim chunks of the range from a shared cursor.
+template <typename F>
+void parallel_for(size_t begin, size_t end, unsigned nthreads, F fn, size_t chunk = 1024)
+{
+    if (nthreads == 0)
+        nthreads = csr_default_threads();
+    if (end <= begin)
+        return;
+    if (nthreads == 1 || end - begin <= chunk)
+    {
+        for (size_t i = begin; i < end; i++)
+            fn(i);
+        return;
+    }
+
+    std::atomic<size_t> cursor(begin);
+    auto worker = [&]() {
+        size_t lo;
+        while ((lo = cursor.fetch_add(chunk, std::memory_order_relaxed)) < end)
+        {
+            size_t hi = std::min(lo + chunk, end);
+            for (size_t i = lo; i < hi; i++)
+                fn(i);
+        }
+    };
+    std::vector<std::thread> workers;
+    for (unsigned t = 1; t < nthreads; t++)
+        workers.push_back(std::thread(worker));
+    worker();
+    for (auto &w : workers)
+        w.join();
+}
+
+// Build the symmetric CSR of an undirected graph with n nodes from m edges,
+// where edge_at(i) returns the endpoints of edge i as a pair. Self-loops are
+// dropped, and duplicate and reversed edges are merged.
+//
+//  1. degree histogram over the edges, with atomic per-node counters
+//  2. prefix sum into offsets
+//  3. scatter both directions of every edge through atomic per-node cursors
+//  4. sort and dedupe every neighbor list in parallel
+//  5. compact the lists into the final array
+//
+// edge_at is not called after step 3; edges_done, if given, runs at that point
+// so the caller can release its edge list before the compacted copy is made.
+//
+// On return *cd (n+1 entries) and *adj (cd[n] entries) hold the graph, each
+// allocated with bigalloc; the caller releases them with bigfree. Returns cd[n].
+template <typename EdgeAt>
+size_t build_csr(unsigned n, size_t m, EdgeAt edge_at, unsigned **cd, unsigned **adj, unsigned nthreads = 0,
+                 const std::function<void()> &edges_done = nullptr)
+{
+    std::vector<std::atomic<size_t>> cursor(n + 1);
+    parallel_for(0, n + 1, nthreads, [&](size_t v) { cursor[v].store(0, std::memory_order_relaxed); });
+
+    // 1. degrees
+    parallel_for(0, m, nthreads, [&](size_t i) {
+        std::pair<unsigned, unsigned> e = edge_at(i);
+        if (e.first != e.second)
+        {
+            cursor[e.first].fetch_add(1, std::memory_order_relaxed);
+            cursor[e.second].fetch_add(1, std::memory_order_relaxed);
+        }
+    }, 1 << 16);
+
+    // 2. offsets of the scatter buffer
+    std::vector<size_t> start(n + 1);
+    start[0] = 0;
+    for (unsigned v = 0; v < n; v++)
+    {
+        start[v + 1] = start[v] + cursor[v].load(std::memory_order_relaxed);
+        cursor[v].store(start[v], std::memory_order_relaxed);
+    }
+
+    // 3. scatter
+    std::vector<unsigned> buf(start[n]);
+    parallel_for(0, m, nthreads, [&](size_t i) {
+        std::pair<unsigned, unsigned> e = edge_at(i);
+        if (e.first != e.second)
+        {
+            buf[cursor[e.first].fetch_add(1, std::memory_order_relaxed)] = e.second;
+            buf[cursor[e.second].fetch_add(1, std::memory_order_relaxed)] = e.first;
+        }
+    }, 1 << 16);
+    if (edges_done)
+        edges_done();
+
+    // 4. sort and dedupe each list in place, remembering its new length
+    std::vector<unsigned> deg(n);
+    parallel_for(0, n, nthreads, [&](size_t v) {
+        unsigned *b = buf.data() + start[v], *e = buf.data() + start[v + 1];
+        std::sort(b, e);
+        deg[v] = std::unique(b, e) - b;
+    }, 256);
+
+    // 5. compact
+    *cd = (unsigned *)bigalloc((n + 1) * sizeof(unsigned));
+    (*cd)[0] = 0;
+    for (unsigned v = 0; v < n; v++)
+        (*cd)[v + 1] = (*cd)[v] + deg[v];
+    *adj = (unsigned *)bigalloc((size_t)(*cd)[n] * sizeof(unsigned));
+    parallel_for(0, n, nthreads, [&](size_t v) {
+        std::copy(buf.begin() + start[v], buf.begin() + start[v] + deg[v], *adj + (*cd)[v]);
+    }, 256);
+
+    return (*cd)[n];
+}
+
+#endif
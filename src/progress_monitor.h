@@ -0,0 +1,94 @@
+#ifndef PROGRESS_MONITOR_H
+#define PROGRESS_MONITOR_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+// Counters published by the enumeration. Workers only ever do relaxed atomic
+// updates here; all printing happens on the monitor thread.
+struct ProgressCounters {
+    std::atomic<long long> cliques{0};     // Maximal cliques found
+    std::atomic<long long> roots_done{0};  // Root subproblems finished
+    std::atomic<long long> roots_total{0}; // Root subproblems overall
+    std::atomic<long long> work_done{0};   // Summed size of finished roots
+    std::atomic<long long> work_total{0};  // Summed size of all roots
+
+    void reset() {
+        cliques = roots_done = roots_total = work_done = work_total = 0;
+    }
+};
+
+// Background thread that periodically reports throughput, the fraction of
+// root subproblems done and an ETA weighted by subproblem size. Human-readable
+// lines go to stdout, JSON lines (one object per report) to stderr.
+class ProgressMonitor {
+public:
+    ProgressMonitor(const ProgressCounters& counters, double interval_seconds, bool json)
+        : counters(counters), interval(interval_seconds), json(json), stopping(false),
+          start(std::chrono::steady_clock::now()) {
+        if (interval > 0) worker = std::thread(&ProgressMonitor::run, this);
+    }
+
+    ~ProgressMonitor() {
+        stop();
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        if (worker.joinable()) worker.join();
+    }
+
+private:
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        auto period = std::chrono::duration<double>(interval);
+        while (!wake.wait_for(lock, period, [this] { return stopping; })) {
+            report();
+        }
+    }
+
+    void report() {
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        long long cliques = counters.cliques.load(std::memory_order_relaxed);
+        long long roots_done = counters.roots_done.load(std::memory_order_relaxed);
+        long long roots_total = counters.roots_total.load(std::memory_order_relaxed);
+        long long work_done = counters.work_done.load(std::memory_order_relaxed);
+        long long work_total = counters.work_total.load(std::memory_order_relaxed);
+
+        double rate = elapsed > 0 ? cliques / elapsed : 0;
+        double fraction = roots_total > 0 ? double(roots_done) / roots_total : 0;
+        double work_fraction = work_total > 0 ? double(work_done) / work_total : 0;
+        double eta = work_fraction > 0 ? elapsed * (1 - work_fraction) / work_fraction : -1;
+
+        if (json) {
+            std::cerr << "{\"elapsed\":" << elapsed << ",\"cliques\":" << cliques
+                      << ",\"cliques_per_second\":" << rate << ",\"roots_done\":" << roots_done
+                      << ",\"roots_total\":" << roots_total << ",\"work_fraction\":" << work_fraction
+                      << ",\"eta_seconds\":" << eta << "}" << std::endl;
+        } else {
+            std::cout << "Progress: " << cliques << " cliques (" << (long long)rate << "/s), "
+                      << roots_done << "/" << roots_total << " roots (" << (int)(fraction * 100) << "%)";
+            if (eta >= 0) std::cout << ", ETA " << eta << " s";
+            std::cout << std::endl;
+        }
+    }
+
+    const ProgressCounters& counters;
+    double interval;
+    bool json;
+    bool stopping;
+    std::chrono::steady_clock::time_point start;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::thread worker;
+};
+
+#endif
@@ -2,15 +2,17 @@
 #include <fstream>
 #include <sstream>
 #include <string>
+#include <cstdlib>
 #include <vector>
 #include <unordered_set>
 #include <algorithm>
 #include <chrono>
+#include <utility>
+#include "progress_monitor.h"
+#include "csr_builder.h"
 
 // Maximum number of vertices (adjusted for 10 lakh nodes)
 const int MAX_VERTICES = 1000000;
-// Progress reporting interval (1 lakh = 100,000)
-const int PROGRESS_INTERVAL = 10000;
 
 class Graph {
 private:
@@ -19,21 +21,21 @@ private:
     std::vector<int> Q;                         // Current clique
     int maxCliqueSize;                          // Track the largest clique size
     long long cliqueCount;                      // Count total cliques found
-    long long lastReportedCount;                // Last reported count for progress tracking
+    std::vector<long long> sizeCount;           // Maximal cliques found per size
+    ProgressCounters* progress;                 // Counters read by the progress monitor (optional)
+    std::vector<int> nodeIds;                   // Original ID of each vertex
+    std::ostream* cliqueOut;                    // Receives every maximal clique (optional)
 
 public:
-    Graph(int vertices) : V(vertices), maxCliqueSize(0), cliqueCount(0), lastReportedCount(0) {
+    Graph(int vertices) : V(vertices), maxCliqueSize(0), cliqueCount(0), progress(nullptr), cliqueOut(nullptr) {
         adj.resize(vertices);
     }
 
-    // Add an edge between vertices u and v
-    void addEdge(int u, int v) {
-        // Ensure vertices are valid
-        if (u >= V) resizeGraph(u + 1);
-        if (v >= V) resizeGraph(v + 1);
-
-        adj[u].insert(v);
-        adj[v].insert(u); // For undirected graph
+    // Replace the neighbors of u; safe to call concurrently for different u
+    void setNeighbors(int u, const unsigned* begin, const unsigned* end) {
+        adj[u].clear();
+        adj[u].reserve(end - begin);
+        adj[u].insert(begin, end);
     }
 
     // Resize graph if needed
@@ -42,12 +44,27 @@ public:
         V = newSize;
     }
 
+    // Remember the original ID of each vertex, used when printing cliques
+    void setNodeIds(const std::vector<int>& ids) {
+        nodeIds = ids;
+    }
+
+    // Write every maximal clique found to out, one per line as sorted original IDs
+    void setCliqueOutput(std::ostream* out) {
+        cliqueOut = out;
+    }
+
+    // Publish progress to the given counters during findMaximalCliques
+    void setProgress(ProgressCounters* counters) {
+        progress = counters;
+    }
+
     // Main function to find all maximal cliques - returns statistics only
     std::pair<long long, int> findMaximalCliques() {
         Q.clear();
         cliqueCount = 0;
-        lastReportedCount = 0;
         maxCliqueSize = 0;
+        sizeCount.assign(1, 0);
 
         // Create initial sets for EXPAND
         std::vector<bool> SUBG(V, true);
@@ -56,12 +73,6 @@ public:
         // Find cliques without writing to file
         EXPAND(SUBG, CAND);
 
-        // Report final progress if not already reported
-        if (cliqueCount > lastReportedCount) {
-            std::cout << "Progress: " << cliqueCount << " cliques found, current max size: " 
-                      << maxCliqueSize << std::endl;
-        }
-
         return {cliqueCount, maxCliqueSize};
     }
 
@@ -70,7 +81,20 @@ public:
         return V;
     }
 
+    // Number of maximal cliques of each size found by the last run
+    const std::vector<long long>& getSizeCounts() const {
+        return sizeCount;
+    }
+
 private:
+    void printClique() {
+        std::vector<int> ids;
+        for (int q : Q) ids.push_back(q < (int)nodeIds.size() ? nodeIds[q] : q);
+        std::sort(ids.begin(), ids.end());
+        for (size_t i = 0; i < ids.size(); i++) *cliqueOut << (i ? " " : "") << ids[i];
+        *cliqueOut << '\n';
+    }
+
     // Optimized EXPAND procedure without file I/O
     void EXPAND(std::vector<bool>& SUBG, std::vector<bool>& CAND) {
         // Check if SUBG is empty
@@ -86,13 +110,10 @@ private:
         if (isEmpty) {
             cliqueCount++;
             maxCliqueSize = std::max(maxCliqueSize, static_cast<int>(Q.size()));
-            
-            // Check if we need to report progress
-            if (cliqueCount >= lastReportedCount + PROGRESS_INTERVAL) {
-                lastReportedCount = cliqueCount;
-                std::cout << "Progress: " << cliqueCount << " cliques found, current max size: " 
-                          << maxCliqueSize << std::endl;
-            }
+            if (Q.size() >= sizeCount.size()) sizeCount.resize(Q.size() + 1, 0);
+            sizeCount[Q.size()]++;
+            if (progress) progress->cliques.fetch_add(1, std::memory_order_relaxed);
+            if (cliqueOut) printClique();
             return;
         }
 
@@ -126,6 +147,15 @@ private:
             }
         }
 
+        // The top-level candidates are the root subproblems, weighted by degree
+        bool root = Q.empty();
+        if (root && progress) {
+            long long work = 0;
+            for (int q : candidates) work += adj[q].size() + 1;
+            progress->roots_total.store(candidates.size(), std::memory_order_relaxed);
+            progress->work_total.store(work, std::memory_order_relaxed);
+        }
+
         // Process candidates
         for (int q : candidates) {
             // Add q to Q
@@ -151,11 +181,18 @@ private:
             
             // Remove q from Q (backtracking)
             Q.pop_back();
+
+            if (root && progress) {
+                progress->roots_done.fetch_add(1, std::memory_order_relaxed);
+                progress->work_done.fetch_add(adj[q].size() + 1, std::memory_order_relaxed);
+            }
         }
     }
 };
 
-// Function to read graph from file - minimal output
+// Function to read graph from file - minimal output. Node IDs are remapped to
+// consecutive indices so that gaps in the ID space do not become isolated
+// vertices (each of which would count as a maximal clique).
 bool readGraphFromFile(const std::string& filename, Graph& graph) {
     std::ifstream file(filename);
     if (!file.is_open()) {
@@ -164,19 +201,11 @@ bool readGraphFromFile(const std::string& filename, Graph& graph) {
     }
 
     std::string line;
-    int maxNodeId = -1;
-    int edgeCount = 0;
+    std::vector<std::pair<int, int>> edges;
 
-    // Skip comment lines
+    // Process edge lines, skipping comments
     while (std::getline(file, line)) {
-        if (line.empty() || line[0] != '#') {
-            break;
-        }
-    }
-
-    // Process edge lines
-    do {
-        if (line.empty()) continue;
+        if (line.empty() || line[0] == '#') continue;
 
         std::istringstream iss(line);
         int from, to;
@@ -186,16 +215,41 @@ bool readGraphFromFile(const std::string& filename, Graph& graph) {
             continue;
         }
 
-        maxNodeId = std::max(maxNodeId, std::max(from, to));
-        graph.addEdge(from, to);
-        edgeCount++;
-
-    } while (std::getline(file, line));
+        edges.push_back({from, to});
+    }
 
     file.close();
 
-    std::cout << "Graph loaded: " << (maxNodeId + 1) << " vertices, " 
-              << edgeCount << " edges" << std::endl;
+    // Map original IDs to consecutive indices
+    std::vector<int> ids;
+    ids.reserve(2 * edges.size());
+    for (const auto& e : edges) {
+        ids.push_back(e.first);
+        ids.push_back(e.second);
+    }
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    auto index = [&ids](int id) {
+        return static_cast<int>(std::lower_bound(ids.begin(), ids.end(), id) - ids.begin());
+    };
+
+    // Build the adjacency in parallel: CSR first, then one hash set per vertex
+    unsigned n = ids.size();
+    unsigned *cd, *adj;
+    build_csr(n, edges.size(), [&](size_t i) {
+        return std::make_pair((unsigned)index(edges[i].first), (unsigned)index(edges[i].second));
+    }, &cd, &adj);
+
+    graph.resizeGraph(n);
+    parallel_for(0, n, 0, [&](size_t v) {
+        graph.setNeighbors(v, adj + cd[v], adj + cd[v + 1]);
+    });
+    bigfree(adj, (size_t)cd[n] * sizeof(unsigned));
+    bigfree(cd, (n + 1) * sizeof(unsigned));
+    graph.setNodeIds(ids);
+
+    std::cout << "Graph loaded: " << ids.size() << " vertices, " 
+              << edges.size() << " edges" << std::endl;
     
     return true;
 }
@@ -203,9 +257,33 @@ bool readGraphFromFile(const std::string& filename, Graph& graph) {
 int main(int argc, char* argv[]) {
     std::string inputFilename = "wiki-Vote.txt";
     std::string outputFilename = "clique_results_summary.txt";
-
-    if (argc > 1) inputFilename = argv[1];
-    if (argc > 2) outputFilename = argv[2];
+    double progressInterval = 1.0;
+    bool progressJson = false;
+    std::string cliquesFilename;
+
+    // Positional arguments: input file, summary file; options may appear anywhere
+    int positional = 0;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--progress" && i + 1 < argc) {
+            char* end;
+            progressInterval = std::strtod(argv[++i], &end);
+            if (end == argv[i] || *end != '\0' || !(progressInterval >= 0)) {
+                std::cerr << "Invalid value for --progress: " << argv[i] << " (expected a non-negative number)" << std::endl;
+                return 1;
+            }
+        } else if (arg == "--progress-json") {
+            progressJson = true;
+        } else if (arg == "--cliques" && i + 1 < argc) {
+            cliquesFilename = argv[++i];
+        } else if (positional == 0) {
+            inputFilename = arg;
+            positional++;
+        } else if (positional == 1) {
+            outputFilename = arg;
+            positional++;
+        }
+    }
 
     // Initialize graph
     Graph g(0);
@@ -223,8 +301,22 @@ int main(int argc, char* argv[]) {
     // Record start time
     auto globalStartTime = std::chrono::high_resolution_clock::now();
 
+    std::ofstream cliquesFile;
+    if (!cliquesFilename.empty()) {
+        cliquesFile.open(cliquesFilename);
+        if (!cliquesFile.is_open()) {
+            std::cerr << "Error: Unable to open file " << cliquesFilename << std::endl;
+            return 1;
+        }
+        g.setCliqueOutput(&cliquesFile);
+    }
+
     // Find cliques - only collecting statistics
+    ProgressCounters progress;
+    g.setProgress(&progress);
+    ProgressMonitor monitor(progress, progressInterval, progressJson);
     auto [cliqueCount, maxCliqueSize] = g.findMaximalCliques();
+    monitor.stop();
 
     // Record end time
     auto globalEndTime = std::chrono::high_resolution_clock::now();
@@ -237,12 +329,23 @@ int main(int argc, char* argv[]) {
         outputFile << "Vertices: " << g.getVertexCount() << std::endl;
         outputFile << "Total maximal cliques found: " << cliqueCount << std::endl;
         outputFile << "Size of largest clique: " << maxCliqueSize << std::endl;
+        for (size_t k = 1; k < g.getSizeCounts().size(); k++) {
+            if (g.getSizeCounts()[k] > 0) {
+                outputFile << "Maximal cliques of size " << k << ": " << g.getSizeCounts()[k] << std::endl;
+            }
+        }
         outputFile << "Processing time: " << globalDuration.count() << " seconds" << std::endl;
         outputFile.close();
     }
 
     std::cout << "Total maximal cliques: " << cliqueCount << std::endl;
     std::cout << "Largest clique size: " << maxCliqueSize << std::endl;
+    std::cout << "Maximal cliques by size:" << std::endl;
+    for (size_t k = 1; k < g.getSizeCounts().size(); k++) {
+        if (g.getSizeCounts()[k] > 0) {
+            std::cout << "  " << k << ": " << g.getSizeCounts()[k] << std::endl;
+        }
+    }
     std::cout << "Total execution time: " << globalDuration.count() << " seconds" << std::endl;
 
     return 0;
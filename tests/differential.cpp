@@ -0,0 +1,546 @@
+// Differential and fuzz test for the three enumerators.
+//
+// Generates random graphs and adversarial families, runs tomita, ELS (plain,
+// --reduce, --compressed, --hybrid) and chiba_arboricity on each, and checks
+// every program against a reference Bron-Kerbosch built into this file:
+//   - the set of maximal cliques (tomita and ELS, via --cliques)
+//   - the number of maximal cliques of each size and the largest size
+//   - the number of k-cliques for every k (chiba_arboricity), derived from
+//     the reference maximal cliques
+// The wall time of every program summed over all graphs is compared against a
+// baseline file, and any program slower by more than the threshold is flagged.
+//
+// Build and run (after building the three programs into BIN_DIR):
+//   g++ -O2 -std=c++17 -o differential tests/differential.cpp
+//   ./differential BIN_DIR [--rounds N] [--seed S] [--baseline FILE]
+//                  [--save-baseline FILE] [--threshold FRACTION] [--keep]
+//
+// Exits with status 1 on any mismatch or timing regression. Inputs of failing
+// cases are kept in the scratch directory, which is printed.
+
+#include <vector>
+#include <set>
+#include <map>
+#include <algorithm>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <random>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+
+using namespace std;
+
+typedef vector<vector<int>> CliqueList;
+
+struct TestGraph {
+    string family;
+    vector<pair<int, int>> edges; // Original node IDs, exactly as written
+};
+
+struct Engine {
+    string name;
+    string program;
+    string options;
+    bool lists_cliques; // Supports --cliques; otherwise prints k-clique counts
+};
+
+mt19937 rng;
+
+int randomInt(int lo, int hi) {
+    return uniform_int_distribution<int>(lo, hi)(rng);
+}
+
+double randomReal() {
+    return uniform_real_distribution<double>(0, 1)(rng);
+}
+
+// ---------------------------------------------------------------------------
+// Graph families
+
+TestGraph randomGraph(int n, double p) {
+    TestGraph g;
+    g.family = "random(" + to_string(n) + "," + to_string(p).substr(0, 4) + ")";
+    for (int u = 0; u < n; u++) {
+        for (int v = u + 1; v < n; v++) {
+            if (randomReal() < p) g.edges.push_back({u, v});
+        }
+    }
+    return g;
+}
+
+// Random sparse graph with a few planted cliques
+TestGraph plantedGraph(int n, double p, int cliques, int size) {
+    TestGraph g = randomGraph(n, p);
+    g.family = "planted(" + to_string(n) + "," + to_string(cliques) + "x" + to_string(size) + ")";
+    for (int c = 0; c < cliques; c++) {
+        vector<int> members;
+        while ((int)members.size() < size) {
+            int v = randomInt(0, n - 1);
+            if (find(members.begin(), members.end(), v) == members.end()) members.push_back(v);
+        }
+        for (int i = 0; i < size; i++) {
+            for (int j = i + 1; j < size; j++) g.edges.push_back({members[i], members[j]});
+        }
+    }
+    return g;
+}
+
+// Complete multipartite graph: every maximal clique takes one vertex per part
+TestGraph multipartiteGraph(const vector<int>& parts) {
+    TestGraph g;
+    g.family = "multipartite(";
+    vector<int> part_of;
+    for (size_t p = 0; p < parts.size(); p++) {
+        g.family += (p ? "," : "") + to_string(parts[p]);
+        for (int i = 0; i < parts[p]; i++) part_of.push_back(p);
+    }
+    g.family += ")";
+    for (size_t u = 0; u < part_of.size(); u++) {
+        for (size_t v = u + 1; v < part_of.size(); v++) {
+            if (part_of[u] != part_of[v]) g.edges.push_back({(int)u, (int)v});
+        }
+    }
+    return g;
+}
+
+// Moon-Moser graph on 3k vertices: the most maximal cliques possible, 3^k
+TestGraph moonMoserGraph(int k) {
+    TestGraph g = multipartiteGraph(vector<int>(k, 3));
+    g.family = "moon-moser(" + to_string(k) + ")";
+    return g;
+}
+
+// ---------------------------------------------------------------------------
+// Input mutations that must not change the answer
+
+vector<int> nodesOf(const TestGraph& g) {
+    vector<int> nodes;
+    for (const auto& e : g.edges) {
+        nodes.push_back(e.first);
+        nodes.push_back(e.second);
+    }
+    sort(nodes.begin(), nodes.end());
+    nodes.erase(unique(nodes.begin(), nodes.end()), nodes.end());
+    return nodes;
+}
+
+// Self-loops on existing vertices, plus one vertex that only has a self-loop
+void addSelfLoops(TestGraph& g) {
+    vector<int> nodes = nodesOf(g);
+    for (int i = 0; i < 3 && !nodes.empty(); i++) {
+        int v = nodes[randomInt(0, nodes.size() - 1)];
+        g.edges.push_back({v, v});
+    }
+    int lonely = nodes.empty() ? 0 : nodes.back() + 1;
+    g.edges.push_back({lonely, lonely});
+    g.family += "+loops";
+}
+
+// Repeat some edges as-is and some reversed
+void addDuplicates(TestGraph& g) {
+    size_t m = g.edges.size();
+    for (size_t i = 0; i < m; i++) {
+        double r = randomReal();
+        if (r < 0.2) g.edges.push_back(g.edges[i]);
+        else if (r < 0.4) g.edges.push_back({g.edges[i].second, g.edges[i].first});
+    }
+    g.family += "+dups";
+}
+
+// Spread the IDs over a large, gappy range in a random order
+void relabel(TestGraph& g) {
+    vector<int> nodes = nodesOf(g);
+    set<int> used;
+    map<int, int> label;
+    for (int v : nodes) {
+        int id;
+        do id = randomInt(0, 1 << 30); while (!used.insert(id).second);
+        label[v] = id;
+    }
+    for (auto& e : g.edges) e = {label[e.first], label[e.second]};
+    g.family += "+relabel";
+}
+
+void writeGraph(const TestGraph& g, const string& path) {
+    ofstream out(path);
+    out << "# " << g.family << "\n";
+    for (const auto& e : g.edges) out << e.first << " " << e.second << "\n";
+}
+
+// ---------------------------------------------------------------------------
+// Reference: Bron-Kerbosch with Tomita pivoting on sorted vectors
+
+struct Reference {
+    vector<int> ids;          // Index -> original ID
+    vector<vector<int>> adj;  // Sorted neighbor indices
+    CliqueList cliques;       // Sorted original IDs, list sorted
+};
+
+vector<int> intersect(const vector<int>& a, const vector<int>& b) {
+    vector<int> out;
+    set_intersection(a.begin(), a.end(), b.begin(), b.end(), back_inserter(out));
+    return out;
+}
+
+void referenceExpand(Reference& ref, vector<int>& R, vector<int> P, vector<int> X) {
+    if (P.empty()) {
+        if (X.empty()) {
+            vector<int> C;
+            for (int v : R) C.push_back(ref.ids[v]);
+            sort(C.begin(), C.end());
+            ref.cliques.push_back(C);
+        }
+        return;
+    }
+    int pivot = -1;
+    size_t best = 0;
+    for (const vector<int>* S : {&P, &X}) {
+        for (int u : *S) {
+            size_t covered = intersect(P, ref.adj[u]).size();
+            if (pivot < 0 || covered > best) {
+                pivot = u;
+                best = covered;
+            }
+        }
+    }
+    vector<int> branch;
+    set_difference(P.begin(), P.end(), ref.adj[pivot].begin(), ref.adj[pivot].end(), back_inserter(branch));
+    for (int v : branch) {
+        R.push_back(v);
+        referenceExpand(ref, R, intersect(P, ref.adj[v]), intersect(X, ref.adj[v]));
+        R.pop_back();
+        P.erase(lower_bound(P.begin(), P.end(), v));
+        X.insert(lower_bound(X.begin(), X.end(), v), v);
+    }
+}
+
+Reference referenceCliques(const TestGraph& g) {
+    Reference ref;
+    ref.ids = nodesOf(g);
+    ref.adj.resize(ref.ids.size());
+    auto index = [&](int id) { return int(lower_bound(ref.ids.begin(), ref.ids.end(), id) - ref.ids.begin()); };
+    for (const auto& e : g.edges) {
+        int u = index(e.first), v = index(e.second);
+        if (u == v) continue;
+        ref.adj[u].push_back(v);
+        ref.adj[v].push_back(u);
+    }
+    for (auto& list : ref.adj) {
+        sort(list.begin(), list.end());
+        list.erase(unique(list.begin(), list.end()), list.end());
+    }
+    vector<int> R, P(ref.ids.size());
+    for (size_t v = 0; v < P.size(); v++) P[v] = v;
+    referenceExpand(ref, R, P, {});
+    sort(ref.cliques.begin(), ref.cliques.end());
+    return ref;
+}
+
+// Number of maximal cliques of each size
+map<int, long long> sizeHistogram(const CliqueList& cliques) {
+    map<int, long long> hist;
+    for (const auto& C : cliques) hist[C.size()]++;
+    return hist;
+}
+
+// Number of k-cliques for every k: the distinct k-subsets of maximal cliques
+map<int, long long> kCliqueCounts(const CliqueList& cliques) {
+    map<int, set<vector<int>>> subsets;
+    for (const auto& C : cliques) {
+        int s = C.size();
+        for (unsigned long long mask = 1; mask < (1ULL << s); mask++) {
+            vector<int> S;
+            for (int i = 0; i < s; i++) {
+                if (mask >> i & 1) S.push_back(C[i]);
+            }
+            subsets[S.size()].insert(S);
+        }
+    }
+    map<int, long long> counts;
+    for (const auto& entry : subsets) counts[entry.first] = entry.second.size();
+    return counts;
+}
+
+// ---------------------------------------------------------------------------
+// Running the programs and reading their output
+
+string readFile(const string& path) {
+    ifstream in(path);
+    stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+CliqueList readCliques(const string& path) {
+    CliqueList cliques;
+    ifstream in(path);
+    string line;
+    while (getline(in, line)) {
+        istringstream iss(line);
+        vector<int> C;
+        int v;
+        while (iss >> v) C.push_back(v);
+        sort(C.begin(), C.end());
+        cliques.push_back(C);
+    }
+    sort(cliques.begin(), cliques.end());
+    return cliques;
+}
+
+// Value after the first occurrence of label, or -1
+long long findNumber(const string& text, const string& label) {
+    size_t pos = text.find(label);
+    if (pos == string::npos) return -1;
+    return atoll(text.c_str() + pos + label.size());
+}
+
+// "  k: count" lines following "Maximal cliques by size:" (ELS, tomita)
+map<int, long long> parseSizeHistogram(const string& text) {
+    map<int, long long> hist;
+    size_t pos = text.find("Maximal cliques by size:");
+    if (pos == string::npos) return hist;
+    istringstream iss(text.substr(pos));
+    string line;
+    getline(iss, line);
+    int k;
+    long long count;
+    while (getline(iss, line) && sscanf(line.c_str(), " %d: %lld", &k, &count) == 2) hist[k] = count;
+    return hist;
+}
+
+// "| k | count |" rows of the summary table (chiba_arboricity)
+map<int, long long> parseCountTable(const string& text) {
+    map<int, long long> counts;
+    istringstream iss(text);
+    string line;
+    int k;
+    long long count;
+    while (getline(iss, line)) {
+        if (sscanf(line.c_str(), "| %d | %lld", &k, &count) == 2) counts[k] = count;
+    }
+    return counts;
+}
+
+string describe(const map<int, long long>& m) {
+    string out;
+    for (const auto& entry : m) out += " " + to_string(entry.first) + ":" + to_string(entry.second);
+    return out.empty() ? " (none)" : out;
+}
+
+// Run one program on one graph; returns the failures found, empty if it agreed
+vector<string> checkEngine(const Engine& engine, const string& bin_dir, const string& graph_path,
+                           const string& work_dir, const Reference& ref, const map<int, long long>& kcounts,
+                           double& seconds) {
+    vector<string> failures;
+    string out_path = work_dir + "/out.txt", cliques_path = work_dir + "/cliques.txt";
+    remove(cliques_path.c_str());
+
+    string cmd = "'" + bin_dir + "/" + engine.program + "' '" + graph_path + "'";
+    if (engine.program == "tomita") cmd += " /dev/null";
+    cmd += " " + engine.options;
+    if (engine.lists_cliques) cmd += " --cliques '" + cliques_path + "' --progress 0";
+    cmd += " > '" + out_path + "' 2>&1";
+
+    auto start = chrono::steady_clock::now();
+    int status = system(cmd.c_str());
+    seconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    if (status != 0) {
+        failures.push_back("exit status " + to_string(status));
+        return failures;
+    }
+    string text = readFile(out_path);
+
+    map<int, long long> hist = sizeHistogram(ref.cliques);
+    long long max_size = hist.empty() ? 0 : hist.rbegin()->first;
+
+    if (engine.lists_cliques) {
+        CliqueList found = readCliques(cliques_path);
+        if (found != ref.cliques) {
+            CliqueList missing, extra;
+            set_difference(ref.cliques.begin(), ref.cliques.end(), found.begin(), found.end(), back_inserter(missing));
+            set_difference(found.begin(), found.end(), ref.cliques.begin(), ref.cliques.end(), back_inserter(extra));
+            failures.push_back("clique sets differ: " + to_string(missing.size()) + " missing, " +
+                               to_string(extra.size()) + " extra (" + to_string(found.size()) + " listed, " +
+                               to_string(ref.cliques.size()) + " expected)");
+        }
+        map<int, long long> printed = parseSizeHistogram(text);
+        if (printed != hist) {
+            failures.push_back("sizes:" + describe(printed) + " expected" + describe(hist));
+        }
+        long long total = engine.program == "tomita" ? findNumber(text, "Total maximal cliques: ")
+                                                     : findNumber(text, "Total maximal cliques found: ");
+        if (total != (long long)ref.cliques.size()) {
+            failures.push_back("total " + to_string(total) + " expected " + to_string(ref.cliques.size()));
+        }
+        long long largest = engine.program == "tomita" ? findNumber(text, "Largest clique size: ")
+                                                       : findNumber(text, "Size of largest clique: ");
+        if (largest != max_size) {
+            failures.push_back("max size " + to_string(largest) + " expected " + to_string(max_size));
+        }
+    } else {
+        map<int, long long> counts = parseCountTable(text);
+        for (auto it = counts.begin(); it != counts.end();) {
+            if (it->second == 0) it = counts.erase(it);
+            else ++it;
+        }
+        if (counts != kcounts) {
+            failures.push_back("k-cliques:" + describe(counts) + " expected" + describe(kcounts));
+        }
+        long long largest = findNumber(text, "Maximal Clique Size : ");
+        if (largest != max_size) {
+            failures.push_back("max size " + to_string(largest) + " expected " + to_string(max_size));
+        }
+    }
+    return failures;
+}
+
+// ---------------------------------------------------------------------------
+
+vector<TestGraph> generateRound(int round) {
+    vector<TestGraph> graphs;
+    graphs.push_back(randomGraph(randomInt(5, 40), 0.05 + 0.3 * randomReal()));
+    graphs.push_back(randomGraph(randomInt(5, 25), 0.5 + 0.4 * randomReal()));
+    vector<int> parts(randomInt(2, 6));
+    for (int& p : parts) p = randomInt(1, 4);
+    graphs.push_back(multipartiteGraph(parts));
+    graphs.push_back(moonMoserGraph(randomInt(2, 6)));
+    graphs.push_back(plantedGraph(randomInt(20, 60), 0.05, randomInt(1, 4), randomInt(3, 8)));
+
+    // Every mutation on its own in turn, then all of them together
+    for (size_t i = 0; i < graphs.size(); i++) {
+        int which = (round + i) % 4;
+        if (which == 0 || which == 3) addSelfLoops(graphs[i]);
+        if (which == 1 || which == 3) addDuplicates(graphs[i]);
+        if (which == 2 || which == 3) relabel(graphs[i]);
+        shuffle(graphs[i].edges.begin(), graphs[i].edges.end(), rng);
+    }
+    return graphs;
+}
+
+map<string, double> readBaseline(const string& path) {
+    map<string, double> baseline;
+    ifstream in(path);
+    if (!in.is_open()) throw runtime_error("Could not open file: " + path);
+    string name;
+    double seconds;
+    while (in >> name >> seconds) baseline[name] = seconds;
+    return baseline;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        cerr << "Usage: " << argv[0] << " BIN_DIR [--rounds N] [--seed S] [--baseline FILE]"
+             << " [--save-baseline FILE] [--threshold FRACTION] [--keep]" << endl;
+        return 1;
+    }
+    string bin_dir = argv[1];
+    int rounds = 20;
+    unsigned seed = 1;
+    string baseline_file, save_baseline_file;
+    double threshold = 0.25;
+    bool keep = false;
+    for (int i = 2; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--rounds" && i + 1 < argc) {
+            rounds = stoi(argv[++i]);
+        } else if (arg == "--seed" && i + 1 < argc) {
+            seed = stoul(argv[++i]);
+        } else if (arg == "--baseline" && i + 1 < argc) {
+            baseline_file = argv[++i];
+        } else if (arg == "--save-baseline" && i + 1 < argc) {
+            save_baseline_file = argv[++i];
+        } else if (arg == "--threshold" && i + 1 < argc) {
+            threshold = stod(argv[++i]);
+        } else if (arg == "--keep") {
+            keep = true;
+        } else {
+            cerr << "Unknown option: " << arg << endl;
+            return 1;
+        }
+    }
+    rng.seed(seed);
+
+    vector<Engine> engines = {
+        {"tomita", "tomita", "", true},
+        {"ELS", "ELS", "", true},
+        {"ELS--reduce", "ELS", "--reduce", true},
+        {"ELS--compressed", "ELS", "--compressed", true},
+        {"ELS--hybrid", "ELS", "--hybrid", true},
+        {"chiba_arboricity", "chiba_arboricity", "", false},
+        {"chiba_arboricity--threads2", "chiba_arboricity", "--threads 2", false},
+    };
+
+    char dir_template[] = "/tmp/differential.XXXXXX";
+    if (!mkdtemp(dir_template)) {
+        cerr << "Error: Could not create scratch directory" << endl;
+        return 1;
+    }
+    string work_dir = dir_template;
+
+    // Fuzz rounds, then one larger graph on which the running time is not
+    // dominated by process startup
+    vector<vector<TestGraph>> batches;
+    for (int round = 0; round < rounds; round++) batches.push_back(generateRound(round));
+    TestGraph timed = plantedGraph(3000, 0.004, 30, 8);
+    addDuplicates(timed);
+    relabel(timed);
+    batches.push_back({timed});
+
+    map<string, double> seconds;
+    int graphs_run = 0, failed_graphs = 0;
+    for (const auto& batch : batches) {
+        for (const TestGraph& g : batch) {
+            string graph_path = work_dir + "/graph" + to_string(graphs_run++) + ".txt";
+            writeGraph(g, graph_path);
+            Reference ref = referenceCliques(g);
+            map<int, long long> kcounts = kCliqueCounts(ref.cliques);
+
+            bool failed = false;
+            for (const Engine& engine : engines) {
+                for (const string& failure : checkEngine(engine, bin_dir, graph_path, work_dir, ref, kcounts,
+                                                         seconds[engine.name])) {
+                    cout << "FAIL " << engine.name << " on " << g.family << " (" << graph_path << "): "
+                         << failure << endl;
+                    failed = true;
+                }
+            }
+            if (failed) failed_graphs++;
+            else if (!keep) remove(graph_path.c_str());
+        }
+    }
+    cout << graphs_run << " graphs, " << failed_graphs << " with mismatches" << endl;
+
+    // Timing: total wall time per program against the baseline
+    map<string, double> baseline;
+    if (!baseline_file.empty()) baseline = readBaseline(baseline_file);
+    int regressions = 0;
+    for (const Engine& engine : engines) {
+        double t = seconds[engine.name];
+        cout << "  " << engine.name << ": " << t << " s";
+        auto it = baseline.find(engine.name);
+        if (it != baseline.end()) {
+            cout << " (baseline " << it->second << " s)";
+            if (t > it->second * (1 + threshold)) {
+                cout << "  REGRESSION";
+                regressions++;
+            }
+        }
+        cout << endl;
+    }
+    if (!save_baseline_file.empty()) {
+        ofstream out(save_baseline_file);
+        for (const Engine& engine : engines) out << engine.name << " " << seconds[engine.name] << "\n";
+    }
+
+    remove((work_dir + "/out.txt").c_str());
+    remove((work_dir + "/cliques.txt").c_str());
+    if (failed_graphs == 0 && !keep) rmdir(work_dir.c_str());
+    else cout << "Inputs kept in " << work_dir << endl;
+
+    if (regressions > 0) cout << regressions << " timing regressions above " << threshold * 100 << "%" << endl;
+    return failed_graphs > 0 || regressions > 0 ? 1 : 0;
+}